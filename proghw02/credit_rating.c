@@ -99,6 +99,7 @@ int main() {
 
     // Process the ratings and output results
     ProcessCreditRating(q);
+    queue_free(q);
 
     return 0;
 }
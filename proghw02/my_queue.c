@@ -14,6 +14,9 @@
 #include <stdlib.h>
 #include "my_queue.h"
 
+#define QUEUE_FIRST_SLAB 16		// elements in the first slab of a queue
+#define QUEUE_MAX_SLAB 4096		// slabs stop doubling at this size
+
 // Creates and returns a new queue
 queue newqueue() {
     queue q = (queue)malloc(sizeof(struct queueS)); // Allocate memory for the queue
@@ -22,29 +25,55 @@ queue newqueue() {
         exit(1);
     }
     q->front = NULL; // Initialize the front of the queue
+    q->tail = NULL;
+    q->length = 0;
+    q->free_list = NULL;
+    q->slabs = NULL;
+    q->slab_size = QUEUE_FIRST_SLAB;
     return q;
 }
 
-// Adds an item to the end of the queue
-void enqueue(queue q, void* item) {
-    q_element* new_elem = (q_element*)malloc(sizeof(q_element)); // Allocate memory for the new queue element
-    if (new_elem == NULL) {
+// Allocates a new slab and threads its elements onto the free list
+static void grow_pool(queue q) {
+    struct q_slabS* slab = (struct q_slabS*)malloc(sizeof(struct q_slabS) +
+                                                   q->slab_size * sizeof(q_element));
+    if (slab == NULL) {
         fprintf(stderr, "Failed to allocate memory for a new queue element\n");
         exit(1);
     }
+    slab->next = q->slabs;
+    q->slabs = slab;
+
+    for (int i = 0; i < q->slab_size; i++) {
+        slab->elems[i].next = q->free_list;
+        q->free_list = &slab->elems[i];
+    }
+
+    // Double the next slab so a growing queue needs only O(log n) mallocs
+    if (q->slab_size < QUEUE_MAX_SLAB) {
+        q->slab_size *= 2;
+    }
+}
+
+// Adds an item to the end of the queue
+void enqueue(queue q, void* item) {
+    if (q->free_list == NULL) {
+        grow_pool(q);
+    }
+    q_element* new_elem = q->free_list; // Take an element from the pool
+    q->free_list = new_elem->next;
+
     new_elem->contents = item; // Set the contents of the new element
     new_elem->next = NULL; // Initialize the next pointer
 
-    // If the queue is empty, set the front to the new element. Else, add the new element to the end of the queue
+    // If the queue is empty, set the front to the new element. Else, link it after the tail
     if (isempty(q)) {
         q->front = new_elem;
     } else {
-        q_element* current = q->front;
-        while (current->next != NULL) {
-            current = current->next;
-        }
-        current->next = new_elem;
+        q->tail->next = new_elem;
     }
+    q->tail = new_elem;
+    q->length++;
 }
 
 // Removes and returns the first item from the queue
@@ -56,8 +85,13 @@ void* dequeue(queue q) {
     q_element* front_elem = q->front; // Get the front element
     void* item = front_elem->contents; // Get the contents of the front element
     q->front = front_elem->next; // Set the front of the queue to the next element
+    if (q->front == NULL) {
+        q->tail = NULL;
+    }
+    q->length--;
 
-    free(front_elem); // Free the memory of the front element
+    front_elem->next = q->free_list; // Return the element to the pool
+    q->free_list = front_elem;
     return item;
 }
 
@@ -73,3 +107,22 @@ void* peek(queue q) {
     }
     return q->front->contents;
 }
+
+// Returns the number of items in the queue
+int queue_length(queue q) {
+    return q->length;
+}
+
+// Frees every slab owned by the queue and then the queue itself
+void queue_free(queue q) {
+    if (q == NULL) {
+        return;
+    }
+    struct q_slabS* slab = q->slabs;
+    while (slab != NULL) {
+        struct q_slabS* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    free(q);
+}
@@ -24,8 +24,22 @@ struct q_elementS {
 
 typedef struct q_elementS q_element;
 
+/*
+ * a block of queue elements allocated in one malloc; a queue keeps a
+ * chain of these and hands their elements out through its free list
+ */
+struct q_slabS {
+	struct q_slabS* next;		// next slab owned by the same queue
+	q_element elems[];			// the elements carved out of this slab
+};
+
 struct queueS {
 	q_element* front;
+	q_element* tail;			// last item in queue, NULL when empty
+	int length;					// number of items in queue
+	q_element* free_list;		// recycled elements ready for reuse
+	struct q_slabS* slabs;		// every slab allocated for this queue
+	int slab_size;				// element count of the next slab
 };
 
 //Clint change stack to queue
@@ -70,6 +84,21 @@ void* dequeue (queue q);
  */
 void* peek (queue q);
 
+/*
+ * reports how many items are in a queue
+ * queue q: a queue to check: q must not be NULL
+ * returns: number of items currently in the queue
+ */
+int queue_length (queue q);
+
+/*
+ * releases a queue and every element it ever allocated
+ * queue q: a queue to free; may be NULL
+ * returns: nothing; the items themselves are not freed and any
+ * 			still in the queue are the caller's responsibility
+ */
+void queue_free (queue q);
+
 
 #endif /* MY_QUEUE_H_ */
 
@@ -8,11 +8,19 @@
  * Course: CSCI 356
  * Version 1.0
  */
+#define _GNU_SOURCE  // PIPE_BUF, MAP_ANONYMOUS and syscall under -std=c99
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include <time.h>
 
 // Constants for suits and ranks
@@ -26,6 +34,49 @@ const char *ranks[] = {
     "Jack", "Queen", "King", "Ace" 
 };
 
+// One card as it crosses the pipe, packed into two bytes
+typedef struct {
+    unsigned char rank;
+    unsigned char suit;
+} card_record;
+
+// Cards a child writes at once; PIPE_BUF bytes always fit in the pipe buffer
+#define CARD_BATCH (PIPE_BUF / sizeof(card_record))
+
+// Cards the parent has read from one child but not yet played
+typedef struct {
+    int fd;
+    size_t start, end;  // unplayed bytes are buf[start] up to buf[end]
+    // Room for a few batches, so one read takes whatever has piled up in the pipe
+    unsigned char buf[CARD_BATCH * sizeof(card_record) * 4];
+} card_stream;
+
+// Cards a shared-memory ring holds; a power of two so positions wrap with a mask
+#define RING_CARDS 16384
+
+// Cards moved between publishing the ring positions, so the other side's cache line is not hit every card
+#define RING_PUBLISH 64
+
+// A side asleep on the ring is woken once this many cards are ready for it, so a wakeup moves many cards
+#define RING_WAKE (RING_CARDS / 2)
+
+/* A single-producer, single-consumer ring in memory shared with one child
+ * The child only moves head and the parent only moves tail; both count
+ * cards since the start and wrap freely. Each side sleeps on the other's
+ * position with a futex, and only when the ring is empty or full; it is
+ * woken when half the ring is ready for it, as a pipe's writer is woken
+ * only once a page of the pipe is free.
+ */
+typedef struct {
+    unsigned int head;          // cards written by the child
+    unsigned int parent_asleep; // set while the parent waits for head to move
+    char pad1[56];              // keep the two sides on separate cache lines
+    unsigned int tail;          // cards played by the parent
+    unsigned int child_asleep;  // set while the child waits for tail to move
+    char pad2[56];
+    card_record cards[RING_CARDS];
+} card_ring;
+
 // Function to generate a random card draw
 void draw_card(int *rank, int *suit) {
     // Generate random rank and suit modulo + 2 to avoid 0 and 1
@@ -68,109 +119,312 @@ int determine_winner(int rank1, int suit1, int rank2, int suit2) {
     return 0;  // Return 0 for a absolute tie
 }
 
+// Function to decide a round as determine_winner does, without printing it
+int round_winner(int rank1, int suit1, int rank2, int suit2) {
+    if (rank1 != rank2) {
+        return rank1 > rank2 ? 1 : 2;
+    }
+    if (suit1 != suit2) {
+        return suit1 < suit2 ? 1 : 2;
+    }
+    return 0;
+}
+
+// Function to write a whole buffer, carrying on after short writes
+int write_all(int fd, const void *buf, size_t len) {
+    const char *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+// Function for a child to draw its cards for every round, a batch per write
+void play_child(int fd, int rounds) {
+    card_record batch[CARD_BATCH];
+    size_t count = 0;
+    for (int i = 0; i < rounds; i++) {
+        int rank, suit;
+        draw_card(&rank, &suit);
+        batch[count].rank = rank;
+        batch[count].suit = suit;
+        if (++count == CARD_BATCH || i == rounds - 1) {
+            if (write_all(fd, batch, count * sizeof(card_record)) == -1) {
+                perror("write");
+                exit(1);
+            }
+            count = 0;
+        }
+    }
+}
+
+// Function to take the next card from a child, reading as much as the pipe holds when out
+// Returns 1 for a card, 0 if the child closed its pipe first, -1 on a read error
+int next_card(card_stream *stream, int *rank, int *suit) {
+    if (stream->end - stream->start < sizeof(card_record)) {
+        // Keep any part of a record from a short read in front of the next one
+        memmove(stream->buf, stream->buf + stream->start, stream->end - stream->start);
+        stream->end -= stream->start;
+        stream->start = 0;
+        while (stream->end < sizeof(card_record)) {
+            ssize_t n = read(stream->fd, stream->buf + stream->end, sizeof(stream->buf) - stream->end);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -1;
+            }
+            if (n == 0) {
+                return 0;
+            }
+            stream->end += n;
+        }
+    }
+    card_record card;
+    memcpy(&card, stream->buf + stream->start, sizeof(card));
+    stream->start += sizeof(card);
+    *rank = card.rank;
+    *suit = card.suit;
+    return 1;
+}
+
+// Function to sleep until *word is no longer seen, for at most a tenth of a second
+void ring_sleep(unsigned int *word, unsigned int *asleep, unsigned int seen) {
+    // Raise the flag before the last look, so a publish after the look also sees the flag
+    __atomic_store_n(asleep, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(word, __ATOMIC_SEQ_CST) == seen) {
+        struct timespec timeout = { 0, 100000000 };
+        syscall(SYS_futex, word, FUTEX_WAIT, seen, &timeout, NULL, 0);  // returns at once if *word moved
+    }
+    __atomic_store_n(asleep, 0, __ATOMIC_RELAXED);
+}
+
+// Function to make a new ring position visible, waking the other side if it sleeps on it and wake is set
+void ring_publish(unsigned int *word, unsigned int *asleep, unsigned int value, int wake) {
+    __atomic_store_n(word, value, __ATOMIC_SEQ_CST);
+    if (wake && __atomic_load_n(asleep, __ATOMIC_SEQ_CST)) {
+        syscall(SYS_futex, word, FUTEX_WAKE, 1, NULL, NULL, 0);
+    }
+}
+
+// Function for a child to draw its cards for every round into its ring
+void play_child_ring(card_ring *ring, int rounds) {
+    pid_t parent = getppid();
+    unsigned int head = 0;
+    unsigned int tail = 0;  // the parent's position when last looked at
+    unsigned int published = 0;
+    for (int i = 0; i < rounds; i++) {
+        while (head - tail == RING_CARDS) {
+            // Full: let the parent see everything, then wait for it to make room
+            if (published != head) {
+                ring_publish(&ring->head, &ring->parent_asleep, head, 1);
+                published = head;
+            }
+            tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+            // Once asleep, stay asleep until half the ring is free
+            while (head - tail > RING_CARDS - RING_WAKE) {
+                ring_sleep(&ring->tail, &ring->child_asleep, tail);
+                if (getppid() != parent) {
+                    exit(1);  // the parent is gone
+                }
+                tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+            }
+        }
+        int rank, suit;
+        draw_card(&rank, &suit);
+        card_record *card = &ring->cards[head & (RING_CARDS - 1)];
+        card->rank = rank;
+        card->suit = suit;
+        head++;
+        if (head - published == RING_PUBLISH || i == rounds - 1) {
+            ring_publish(&ring->head, &ring->parent_asleep, head, head % RING_WAKE == 0 || i == rounds - 1);
+            published = head;
+        }
+    }
+}
+
+// Function for the parent to take the next card from a child's ring
+// Returns 1 for a card, 0 if the child exited before writing it
+int next_card_ring(card_ring *ring, pid_t child, unsigned int *head, unsigned int *tail,
+                   int *rank, int *suit) {
+    while (*head == *tail) {
+        // Out of published cards: hand back the room, then wait for more
+        ring_publish(&ring->tail, &ring->child_asleep, *tail, 1);
+        *head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        if (*head == *tail) {
+            ring_sleep(&ring->head, &ring->parent_asleep, *tail);
+            *head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+            if (*head == *tail && waitpid(child, NULL, WNOHANG) != 0) {
+                // Reaped or gone; look once more in case it published just before exiting
+                *head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+                if (*head == *tail) {
+                    return 0;
+                }
+            }
+        }
+    }
+    card_record card = ring->cards[*tail & (RING_CARDS - 1)];
+    *rank = card.rank;
+    *suit = card.suit;
+    ++*tail;
+    if (*tail % RING_PUBLISH == 0) {
+        ring_publish(&ring->tail, &ring->child_asleep, *tail, *tail % RING_WAKE == 0);
+    }
+    return 1;
+}
+
+// Function to read the monotonic clock in seconds
+double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
 int main(int argc, char *argv[]) { 
+    // Pipes unless --shm asks for the shared-memory rings; --quiet or --summary prints no rounds
+    int use_shm = 0, quiet = 0, bad_option = 0;
+    for (int a = 1; a < argc - 1; a++) {
+        if (strcmp(argv[a], "--shm") == 0) {
+            use_shm = 1;
+        } else if (strcmp(argv[a], "--quiet") == 0 || strcmp(argv[a], "--summary") == 0) {
+            quiet = 1;
+        } else {
+            bad_option = 1;
+        }
+    }
+
     // Check for correct number of arguments
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <number_of_rounds>\n", argv[0]);
+    if (argc < 2 || bad_option) {
+        fprintf(stderr, "Usage: %s [--shm] [--quiet | --summary] <number_of_rounds>\n", argv[0]);
         exit(1);
     }
 
     // Ensure rounds argument is a positive integer
-    int rounds = atoi(argv[1]);
+    int rounds = atoi(argv[argc - 1]);
     if (rounds <= 0) {
         fprintf(stderr, "Number of rounds must be a positive integer.\n");
         exit(1);
     }
 
-    // Initialize pipes and fork children
-    int pipe1[2], pipe2[2];  
-    pid_t pid1, pid2;
+    // Initialize the transport and fork children
+    int pipes[2][2];
+    card_ring *rings = NULL;
+    pid_t pids[2];
+    double start = now_seconds();
 
-    // Create pipes
-    if (pipe(pipe1) == -1 || pipe(pipe2) == -1) {
+    if (use_shm) {
+        // Mapped before fork, so both children share it with the parent
+        rings = mmap(NULL, 2 * sizeof(card_ring), PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (rings == MAP_FAILED) {
+            perror("mmap");
+            exit(1);
+        }
+    } else if (pipe(pipes[0]) == -1 || pipe(pipes[1]) == -1) {
         perror("pipe");
         exit(1);
     }
 
-    // Fork child 1
-    if ((pid1 = fork()) == 0) {
-        srand(time(NULL) ^ getpid());  // Unique seed for each child process
+    for (int c = 0; c < 2; c++) {
+        if ((pids[c] = fork()) == 0) {
+            srand(time(NULL) ^ getpid());  // Unique seed for each child process
 
-        close(pipe1[0]);  // Close unused read end
+            if (use_shm) {
+                play_child_ring(&rings[c], rounds);
+            } else {
+                // Close every end but our own write end, so only the parent holds the pipes open
+                close(pipes[c][0]);
+                close(pipes[1 - c][0]);
+                close(pipes[1 - c][1]);
 
-        // Draw cards for each round and write to pipe
-        for (int i = 0; i < rounds; i++) {
-            int rank, suit;
-            draw_card(&rank, &suit);
-            write(pipe1[1], &rank, sizeof(rank)); // Write the drawn cards using the pipe 
-            write(pipe1[1], &suit, sizeof(suit)); // Write the drawn cards using the pipe
+                // Draw cards for each round and write them to the pipe in batches
+                play_child(pipes[c][1], rounds);
+                close(pipes[c][1]);  // Close write end
+            }
+            exit(0);
+        }
+        if (pids[c] == -1) {
+            perror("fork");
+            exit(1);
         }
-        close(pipe1[1]);  // Close write end
-        exit(0); // Exit for next child
     }
 
-    // Fork child 2
-    if ((pid2 = fork()) == 0) {
-        srand(time(NULL) ^ getpid());  // Unique seed for each child process
-
-        close(pipe2[0]);  // Close unused read end
-        for (int i = 0; i < rounds; i++) {
-            int rank, suit;
-            draw_card(&rank, &suit);
-            write(pipe2[1], &rank, sizeof(rank)); // Write the drawn cards using the pipe
-            write(pipe2[1], &suit, sizeof(suit)); // Write the drawn cards using the pipe
+    // Cards arrive in batches; each stream or ring hands them out one per round
+    static card_stream streams[2];
+    unsigned int heads[2] = { 0, 0 }, tails[2] = { 0, 0 };
+    if (!use_shm) {
+        for (int c = 0; c < 2; c++) {
+            close(pipes[c][1]);  // Close unused write ends
+            streams[c].fd = pipes[c][0];
         }
-        close(pipe2[1]);  // Close write end
-        exit(0); // Exit to main
     }
 
-    // Close unused write ends
-    close(pipe1[1]);  
-    close(pipe2[1]);
-
     // Initialize scores
     int score1 = 0, score2 = 0;
 
-    printf("Child 1 PID: %d\n", pid1);
-    printf("Child 2 PID: %d\n", pid2);
+    printf("Child 1 PID: %d\n", pids[0]);
+    printf("Child 2 PID: %d\n", pids[1]);
     printf("Beginning %d Rounds...\n", rounds);
 
     // Play the game for the specified number of rounds
     for (int i = 0; i < rounds; i++) {
-        printf("---------------------------\n");
-        printf("Round %d:\n", i + 1);
-
-        int rank1, suit1, rank2, suit2;
+        if (!quiet) {
+            printf("---------------------------\n");
+            printf("Round %d:\n", i + 1);
+        }
 
-        // Read from child 1
-        read(pipe1[0], &rank1, sizeof(rank1));
-        read(pipe1[0], &suit1, sizeof(suit1));
+        int rank[2], suit[2];
 
-        // Read from child 2
-        read(pipe2[0], &rank2, sizeof(rank2));
-        read(pipe2[0], &suit2, sizeof(suit2));
+        // Take the next card from each child
+        for (int c = 0; c < 2; c++) {
+            int got = use_shm ? next_card_ring(&rings[c], pids[c], &heads[c], &tails[c], &rank[c], &suit[c])
+                              : next_card(&streams[c], &rank[c], &suit[c]);
+            if (got != 1) {
+                if (got == -1) {
+                    perror("read");
+                } else {
+                    fprintf(stderr, "Child %d stopped after %d rounds.\n", c + 1, i);
+                }
+                exit(1);
+            }
+        }
 
         // Determine the winner
-        int winner = determine_winner(rank1, suit1, rank2, suit2);
+        int winner = quiet ? round_winner(rank[0], suit[0], rank[1], suit[1])
+                           : determine_winner(rank[0], suit[0], rank[1], suit[1]);
         
         // Tally the scores
         if (winner == 1) {
             score1++;
         } else if (winner == 2) {
             score2++;
-        } else {
+        } else if (!quiet) {
             printf("It's a Tie!\n");
         }
 
     }
 
     // Close pipes
-    close(pipe1[0]);
-    close(pipe2[0]);
+    if (!use_shm) {
+        close(pipes[0][0]);
+        close(pipes[1][0]);
+    }
 
     // Wait for children to finish
-    wait(NULL);
-    wait(NULL);
+    waitpid(pids[0], NULL, 0);
+    waitpid(pids[1], NULL, 0);
+    double elapsed = now_seconds() - start;
+    if (use_shm) {
+        munmap(rings, 2 * sizeof(card_ring));
+    }
 
     // Print tournament Results
     printf("---------------------------\n");
@@ -185,6 +439,8 @@ int main(int argc, char *argv[]) {
     } else {
         printf("The Tournament is a Tie!\n");
     }
+    printf("Transport: %s, %d rounds in %.3f s, %.0f rounds/sec\n",
+           use_shm ? "shared memory" : "pipes", rounds, elapsed, rounds / elapsed);
 
     return 0;
 }
@@ -11,27 +11,47 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <limits.h>
+#include <getopt.h>
 #include <pthread.h>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
 
 // Struct to pass in the socket information
 typedef struct {
     int thread_socket;
 } thread_data_t;
 
+/* Requests from the parent are a 1-byte opcode followed by a 4-byte
+ * count; a child answers each DRAW with a 4-byte length and then that
+ * many bytes of Cards, one per round asked for
+ */
+#define OP_DRAW 1   // draw count cards
+#define OP_QUIT 2   // count is ignored
+#define REQUEST_SIZE (1 + sizeof(uint32_t))
+
+#define DEFAULT_WINDOW 256  // rounds asked for in each DRAW
+#define MAX_WINDOW 65536
+
+#define MAX_EVENTS 256      // epoll events taken per wait
+
 // Card structure
 typedef struct {
     int rank;   // 2-14 (2-10, Jack=11, Queen=12, King=13, Ace=14)
     char suit[10];  
 } Card;
 
-// Function to draw a random card
-Card draw_card() {
+// Function to draw a random card, from the caller's own generator state if seed is not NULL
+Card draw_card(unsigned int *seed) {
     Card card;
-    card.rank = (rand() % 13) + 2; // Generate rank between 2 and 14
-    int suit_index = rand() % 4;   // Randomize suit index
+    card.rank = ((seed ? rand_r(seed) : rand()) % 13) + 2; // Generate rank between 2 and 14
+    int suit_index = (seed ? rand_r(seed) : rand()) % 4;   // Randomize suit index
 
     // Map suit_index to suit string
     switch (suit_index) {
@@ -53,54 +73,552 @@ int suit_precedence(char *suit) {
     return 0;
 }
 
+// Rank names by rank, so formatting a card needs no memory of its own
+static const char *rank_names[] = {
+    "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "10",
+    "Jack", "Queen", "King", "Ace"
+};
+
 // Format the cards
-char *format_card(Card card) {
-    char *formatted = malloc(20);
-    char *rank;
-    switch (card.rank) {
-        case 11: rank = "Jack"; break;
-        case 12: rank = "Queen"; break;
-        case 13: rank = "King"; break;
-        case 14: rank = "Ace"; break;
-        default: rank = malloc(3);
-                 sprintf(rank, "%d", card.rank);
+const char *format_card(Card card) {
+    return rank_names[card.rank];
+}
+
+// Write the whole buffer, carrying on after short writes
+int write_all(int fd, const void *buf, size_t len) {
+    const char *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+// Read exactly len bytes; returns 0, or -1 on an error or if the other end closed first
+int read_full(int fd, void *buf, size_t len) {
+    char *p = buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (n == 0) {
+            return -1;
+        }
+        p += n;
+        len -= n;
+    }
+    return 0;
+}
+
+// Send a request to a child
+void send_request(int fd, uint8_t opcode, uint32_t count) {
+    unsigned char request[REQUEST_SIZE];
+    request[0] = opcode;
+    memcpy(request + 1, &count, sizeof(count));
+    if (write_all(fd, request, sizeof(request)) < 0) {
+        perror("write");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Ask every child for the next count rounds
+void send_draws(int sockets[2][2], int count) {
+    for (int i = 0; i < 2; i++) {
+        send_request(sockets[i][0], OP_DRAW, count);
+    }
+}
+
+// Read every child's reply to a DRAW of count rounds into cards[child]
+void receive_draws(int sockets[2][2], Card *cards[2], int count) {
+    for (int i = 0; i < 2; i++) {
+        uint32_t length;
+        if (read_full(sockets[i][0], &length, sizeof(length)) < 0 ||
+            length != count * sizeof(Card) ||
+            read_full(sockets[i][0], cards[i], length) < 0) {
+            fprintf(stderr, "Child %d sent a bad reply.\n", i + 1);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+// Read a request and, for a DRAW, send back the cards, building the reply in *reply
+// Returns 0, or -1 on QUIT, a bad request or a closed socket
+int serve_request(int fd, unsigned char **reply, uint32_t *capacity, unsigned int *seed) {
+    unsigned char request[REQUEST_SIZE];
+    uint32_t count;
+    if (read_full(fd, request, sizeof(request)) < 0) {
+        return -1; // Parent is gone
+    }
+    memcpy(&count, request + 1, sizeof(count));
+    if (request[0] != OP_DRAW || count > MAX_WINDOW) {
+        return -1; // QUIT, or an unknown request; closing tells the parent
+    }
+    if (count > *capacity) {
+        unsigned char *grown = realloc(*reply, sizeof(uint32_t) + count * sizeof(Card));
+        if (grown == NULL) {
+            return -1;
+        }
+        *reply = grown;
+        *capacity = count;
     }
-    sprintf(formatted, "%s", rank);
-    return formatted;
+    uint32_t length = count * sizeof(Card);
+    memcpy(*reply, &length, sizeof(length));
+    for (uint32_t i = 0; i < count; i++) {
+        Card card = draw_card(seed);
+        memcpy(*reply + sizeof(length) + i * sizeof(Card), &card, sizeof(Card));
+    }
+    return write_all(fd, *reply, sizeof(length) + length); // Send cards to parent
 }
 
 // Thread function for child threads
 void *child_thread(void *arg) {
     thread_data_t *data = (thread_data_t *)arg; // Get the socket from the thread data
     int socket_fd = data->thread_socket; // Child side
-    while (1) {
-        char buffer[256]; // Buffer for reading commands
-        read(socket_fd, buffer, sizeof(buffer)); // Read command from parent
-        if (strcmp(buffer, "QUIT") == 0) {
-            break; // Exit the thread
-        } else if (strcmp(buffer, "DRAW") == 0) {
-            Card card = draw_card();
-            write(socket_fd, &card, sizeof(Card)); // Send card to parent
+    unsigned char *reply = NULL; // Length, then the cards, sent in one write
+    uint32_t capacity = 0;
+    while (serve_request(socket_fd, &reply, &capacity, NULL) == 0) {
+    }
+    free(reply);
+    close(socket_fd);
+    return NULL;
+}
+
+/* N-player tournaments (-n)
+ * Each player is a socket pair like the two children above, but players
+ * do not get a thread each: a fixed pool of threads shares them, each
+ * thread waiting on its own players with epoll and drawing from each
+ * player's own generator state. The parent waits on every player's socket
+ * in one epoll loop and takes replies in whatever order they come. Every
+ * player is asked for two windows of rounds ahead; when the last player's
+ * cards for a window are in, its rounds are played and the window after
+ * next is asked for. Each round goes to the highest card, suits breaking
+ * ties between equal ranks. With more than two players the top card is
+ * often held twice, so identical cards go to one of their holders picked
+ * at random by the parent, and no seat wins them more often than another.
+ */
+
+// The players one pool thread serves
+typedef struct {
+    int epoll_fd;
+    int live;                   // players not yet told to quit
+    int *fds;                   // every player's pool side, by player
+    unsigned int *seeds;        // every player's generator state, by player
+} pool_worker_t;
+
+// A player as the parent sees it
+typedef struct {
+    int fd;                     // parent side of the player's socket pair
+    int receiving;              // window whose reply is arriving
+    uint32_t length;            // the reply's length, once read
+    size_t got;                 // bytes of the reply read so far, length included
+} player_t;
+
+// One tournament in progress
+typedef struct {
+    int players, window, rounds, windows;
+    player_t *player;
+    Card *cards[2];             // two windows of cards, player by player; window j uses cards[j % 2]
+    int done[2];                // players whose cards are in for the window in each half
+    int resolved;               // windows played
+    double *asked;              // when each window was asked for
+    double *latency;            // how long each window took to come in after
+    int *wins;
+    int *best_rank, *best_suit, *best_player;   // one window's rounds while it is played
+    int *ties;                  // players holding each round's best card so far
+    unsigned int tie_seed;      // the parent's generator state for settling ties
+} tournament_t;
+
+// Results of one tournament
+typedef struct {
+    double seconds;
+    double p50, p99, max;       // round latency in microseconds
+    int winner, winner_wins;
+} tournament_result_t;
+
+// Read the monotonic clock in seconds
+double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Thread function for the pool: serve requests from this thread's players until all quit
+void *pool_thread(void *arg) {
+    pool_worker_t *worker = (pool_worker_t *)arg;
+    unsigned char *reply = NULL;
+    uint32_t capacity = 0;
+    struct epoll_event events[MAX_EVENTS];
+    while (worker->live > 0) {
+        int n = epoll_wait(worker->epoll_fd, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < n; i++) {
+            int p = events[i].data.u32;
+            if (serve_request(worker->fds[p], &reply, &capacity, &worker->seeds[p]) < 0) {
+                epoll_ctl(worker->epoll_fd, EPOLL_CTL_DEL, worker->fds[p], NULL);
+                close(worker->fds[p]);
+                worker->live--;
+            }
         }
     }
+    free(reply);
     return NULL;
 }
 
+// Rounds in window j
+int window_rounds(tournament_t *t, int j) {
+    int left = t->rounds - j * t->window;
+    return left < t->window ? left : t->window;
+}
+
+// Ask every player for window j
+void ask_window(tournament_t *t, int j) {
+    t->asked[j] = now_seconds();
+    for (int p = 0; p < t->players; p++) {
+        send_request(t->player[p].fd, OP_DRAW, window_rounds(t, j));
+    }
+}
+
+// Play window j, whose cards are all in, and ask for the window after next in its place
+void play_window(tournament_t *t, int j) {
+    int count = window_rounds(t, j);
+    Card *cards = t->cards[j % 2];
+    t->latency[j] = now_seconds() - t->asked[j];
+
+    // Player by player, so the cards are read in the order they are stored
+    for (int p = 0; p < t->players; p++) {
+        const Card *hand = cards + (size_t)p * t->window;
+        for (int i = 0; i < count; i++) {
+            if (p > 0 && hand[i].rank < t->best_rank[i]) {
+                continue;
+            }
+            // Suits only matter between equal ranks
+            int suit = suit_precedence((char *)hand[i].suit);
+            if (p == 0 || hand[i].rank > t->best_rank[i] || suit > t->best_suit[i]) {
+                t->best_rank[i] = hand[i].rank;
+                t->best_suit[i] = suit;
+                t->best_player[i] = p;
+                t->ties[i] = 1;
+            } else if (suit == t->best_suit[i]) {
+                // The k-th holder of the same card takes it with chance 1/k,
+                // so each holder ends up with it equally often
+                if (rand_r(&t->tie_seed) % ++t->ties[i] == 0) {
+                    t->best_player[i] = p;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        t->wins[t->best_player[i]]++;
+    }
+
+    t->done[j % 2] = 0;
+    t->resolved++;
+    if (j + 2 < t->windows) {
+        ask_window(t, j + 2);
+    }
+}
+
+// Read whatever player p has sent without blocking, playing each window its cards complete
+void receive_player(tournament_t *t, int p) {
+    player_t *player = &t->player[p];
+    while (player->receiving < t->windows && player->receiving < t->resolved + 2) {
+        int j = player->receiving;
+        size_t length = window_rounds(t, j) * sizeof(Card);
+        char *into = player->got < sizeof(player->length)
+                   ? (char *)&player->length + player->got
+                   : (char *)(t->cards[j % 2] + (size_t)p * t->window) + (player->got - sizeof(player->length));
+        size_t want = player->got < sizeof(player->length)
+                    ? sizeof(player->length) - player->got
+                    : sizeof(player->length) + length - player->got;
+        ssize_t n = recv(player->fd, into, want, MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+            perror("recv");
+            exit(EXIT_FAILURE);
+        }
+        if (n == 0 || (player->got < sizeof(player->length) && player->got + n == sizeof(player->length) &&
+                       player->length != length)) {
+            fprintf(stderr, "Player %d sent a bad reply.\n", p + 1);
+            exit(EXIT_FAILURE);
+        }
+        player->got += n;
+        if (player->got == sizeof(player->length) + length) {
+            player->got = 0;
+            player->receiving++;
+            if (++t->done[j % 2] == t->players) {
+                play_window(t, j);  // windows finish in order, since each player's do
+            }
+        }
+    }
+}
+
+// Percentile of sorted values
+double percentile(const double *sorted, int count, int pct) {
+    int at = (int)((long long)count * pct / 100);
+    return sorted[at < count ? at : count - 1];
+}
+
+int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Play a tournament of rounds between players, served by a pool of threads
+void run_tournament(int players, int threads, int window, int rounds, tournament_result_t *result) {
+    tournament_t t = { 0 };
+    t.players = players;
+    t.window = window;
+    t.rounds = rounds;
+    t.windows = (rounds + window - 1) / window;
+    t.player = calloc(players, sizeof(player_t));
+    t.cards[0] = malloc((size_t)players * window * sizeof(Card));
+    t.cards[1] = malloc((size_t)players * window * sizeof(Card));
+    t.asked = malloc(t.windows * sizeof(double));
+    t.latency = malloc(t.windows * sizeof(double));
+    t.wins = calloc(players, sizeof(int));
+    t.best_rank = malloc(window * sizeof(int));
+    t.best_suit = malloc(window * sizeof(int));
+    t.best_player = malloc(window * sizeof(int));
+    t.ties = malloc(window * sizeof(int));
+    int *pool_fds = malloc(players * sizeof(int));
+    unsigned int *seeds = malloc(players * sizeof(unsigned int));
+    pool_worker_t *workers = calloc(threads, sizeof(pool_worker_t));
+    pthread_t *pool = malloc(threads * sizeof(pthread_t));
+    if (!t.player || !t.cards[0] || !t.cards[1] || !t.asked || !t.latency || !t.wins || !t.best_rank ||
+        !t.best_suit || !t.best_player || !t.ties || !pool_fds || !seeds || !workers || !pool) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+
+    // One socket pair per player; the parent's ends all go in one epoll set
+    int epoll_fd = epoll_create1(0);
+    for (int w = 0; w < threads; w++) {
+        workers[w].epoll_fd = epoll_create1(0);
+        workers[w].fds = pool_fds;
+        workers[w].seeds = seeds;
+        if (workers[w].epoll_fd < 0) {
+            epoll_fd = -1;
+        }
+    }
+    if (epoll_fd < 0) {
+        perror("epoll_create1");
+        exit(EXIT_FAILURE);
+    }
+    unsigned int seed = time(NULL);
+    t.tie_seed = seed ^ 0x9e3779b9u;
+    for (int p = 0; p < players; p++) {
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) < 0) {
+            perror("socketpair");
+            exit(EXIT_FAILURE);
+        }
+        t.player[p].fd = pair[0];
+        pool_fds[p] = pair[1];
+        seeds[p] = seed + p * 2654435761u;
+        pool_worker_t *worker = &workers[p % threads];
+        struct epoll_event parent_event = { .events = EPOLLIN, .data.u32 = p };
+        struct epoll_event pool_event = { .events = EPOLLIN, .data.u32 = p };
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pair[0], &parent_event) < 0 ||
+            epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, pair[1], &pool_event) < 0) {
+            perror("epoll_ctl");
+            exit(EXIT_FAILURE);
+        }
+        worker->live++;
+    }
+    for (int w = 0; w < threads; w++) {
+        if (pthread_create(&pool[w], NULL, pool_thread, &workers[w]) != 0) {
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Two windows ahead, then play windows as the replies complete them
+    double start = now_seconds();
+    for (int j = 0; j < 2 && j < t.windows; j++) {
+        ask_window(&t, j);
+    }
+    struct epoll_event events[MAX_EVENTS];
+    while (t.resolved < t.windows) {
+        int n = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < n; i++) {
+            receive_player(&t, events[i].data.u32);
+        }
+    }
+    result->seconds = now_seconds() - start;
+
+    // Signal players to quit and wait for the pool
+    for (int p = 0; p < players; p++) {
+        send_request(t.player[p].fd, OP_QUIT, 0);
+    }
+    for (int w = 0; w < threads; w++) {
+        pthread_join(pool[w], NULL);
+        close(workers[w].epoll_fd);
+    }
+    for (int p = 0; p < players; p++) {
+        close(t.player[p].fd);
+    }
+    close(epoll_fd);
+
+    // Every round of a window waited as long as the window did
+    qsort(t.latency, t.windows, sizeof(double), compare_doubles);
+    result->p50 = percentile(t.latency, t.windows, 50) * 1e6;
+    result->p99 = percentile(t.latency, t.windows, 99) * 1e6;
+    result->max = t.latency[t.windows - 1] * 1e6;
+    result->winner = 0;
+    for (int p = 1; p < players; p++) {
+        if (t.wins[p] > t.wins[result->winner]) {
+            result->winner = p;
+        }
+    }
+    result->winner_wins = t.wins[result->winner];
+
+    free(t.player);
+    free(t.cards[0]);
+    free(t.cards[1]);
+    free(t.asked);
+    free(t.latency);
+    free(t.wins);
+    free(t.best_rank);
+    free(t.best_suit);
+    free(t.best_player);
+    free(t.ties);
+    free(pool_fds);
+    free(seeds);
+    free(workers);
+    free(pool);
+}
+
+// Run a tournament for each player count in the comma-separated list and print a line for each
+void run_tournaments(const char *list, int threads, int window, int rounds) {
+    // Each player needs two descriptors
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    // Check the whole list before playing any of it
+    for (const char *at = list; ; ) {
+        char *end;
+        long players = strtol(at, &end, 10);
+        if (end == at || (*end != ',' && *end != '\0') || players < 2 || players > INT_MAX / 2) {
+            fprintf(stderr, "Players must be a comma-separated list of numbers of at least 2.\n");
+            exit(EXIT_FAILURE);
+        }
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY &&
+            (rlim_t)players * 2 + 64 > limit.rlim_cur) {
+            fprintf(stderr, "%ld players need more open files than the limit of %lu.\n", players,
+                    (unsigned long)limit.rlim_cur);
+            exit(EXIT_FAILURE);
+        }
+        if (*end == '\0') {
+            break;
+        }
+        at = end + 1;
+    }
+
+    printf("%8s %8s %8s %10s %9s %12s %28s %s\n", "Players", "Threads", "Window", "Rounds", "Seconds",
+           "Rounds/sec", "Round latency us p50/p99/max", "Winner (wins)");
+    for (const char *at = list; *at; ) {
+        char *end;
+        long players = strtol(at, &end, 10);
+        at = *end ? end + 1 : end;
+
+        int pool = threads < players ? threads : players;
+        tournament_result_t result;
+        run_tournament(players, pool, window, rounds, &result);
+        char latency[64];
+        snprintf(latency, sizeof(latency), "%.0f/%.0f/%.0f", result.p50, result.p99, result.max);
+        printf("%8ld %8d %8d %10d %9.3f %12.0f %28s %d (%d)\n", players, pool, window, rounds,
+               result.seconds, rounds / result.seconds, latency, result.winner + 1, result.winner_wins);
+        fflush(stdout);
+    }
+}
+
+// Print a round as it was played
+void print_round(int round, const Card cards[2], int winner) {
+    printf("\nRound %d:\n", round);
+
+    // Print the draws (ranks only)
+    printf("\nChild 1 draws %s \n", format_card(cards[0]));
+    printf("\nChild 2 draws %s \n", format_card(cards[1]));
+
+    // Show suits only when they decided it
+    if (cards[0].rank == cards[1].rank) {
+        printf("\nChecking suits…\n");
+        printf("\nChild 1 draws suit %s %s \n", format_card(cards[0]), cards[0].suit);
+        printf("\nChild 2 draws suit %s %s \n", format_card(cards[1]), cards[1].suit);
+    }
+    printf("\nChild %d Wins!\n", winner + 1);
+    printf("\n---------------------------\n");
+}
+
 // Main function
 int main(int argc, char *argv[]) {
     // Check for correct number of arguments
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <number_of_rounds>", argv[0]);
+    int window = DEFAULT_WINDOW;
+    const char *players = NULL;     // -n: player counts for N-player tournaments
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int pool_threads = cpus > 0 ? cpus : 1;
+    int quiet = 0;                  // --quiet or --summary: no per-round output
+    static const struct option long_options[] = {
+        { "quiet", no_argument, NULL, 'q' },
+        { "summary", no_argument, NULL, 'q' },
+        { NULL, 0, NULL, 0 }
+    };
+    int opt, bad_option = 0;
+    while ((opt = getopt_long(argc, argv, "w:n:t:q", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'w': window = atoi(optarg); break;
+            case 'n': players = optarg; break;
+            case 't': pool_threads = atoi(optarg); break;
+            case 'q': quiet = 1; break;
+            default: bad_option = 1; break;
+        }
+    }
+    if (bad_option || optind != argc - 1) {
+        fprintf(stderr, "Usage: %s [--quiet | --summary] [-w rounds_per_request] [-n players[,players...]] "
+                        "[-t pool_threads] <number_of_rounds>", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    if (window <= 0 || window > MAX_WINDOW) {
+        fprintf(stderr, "Rounds per request must be between 1 and %d.", MAX_WINDOW);
+        exit(EXIT_FAILURE);
+    }
+    if (pool_threads <= 0) {
+        fprintf(stderr, "Pool threads must be greater than 0.");
         exit(EXIT_FAILURE);
     }
 
     // Parse the number of rounds
-    int rounds = atoi(argv[1]);
+    int rounds = atoi(argv[optind]);
     if (rounds <= 0) {
         fprintf(stderr, "Number of rounds must be greater than 0.");
         exit(EXIT_FAILURE);
     }
 
+    if (players != NULL) {
+        run_tournaments(players, pool_threads, window, rounds);
+        return 0;
+    }
+
     // Seed the random number generator
     srand(time(NULL));
 
@@ -137,60 +655,55 @@ int main(int argc, char *argv[]) {
 
     int wins[2] = {0, 0}; // Track wins for each child
 
-    for (int round = 1; round <= rounds; round++) {
-        printf("\nRound %d:\n", round);
-
-        // Signal both children to draw cards
+    // Two windows of cards per child: one being played, one on its way
+    Card *batch[2][2];
+    for (int b = 0; b < 2; b++) {
         for (int i = 0; i < 2; i++) {
-            write(sockets[i][0], "DRAW", strlen("DRAW") + 1);
+            batch[b][i] = malloc(window * sizeof(Card));
+            if (batch[b][i] == NULL) {
+                perror("malloc");
+                exit(EXIT_FAILURE);
+            }
         }
+    }
 
-        // Receive cards from both children
-        Card cards[2];
-        for (int i = 0; i < 2; i++) {
-            read(sockets[i][0], &cards[i], sizeof(Card));
+    // Ask for the first window; each later one is asked for before the one before it is played
+    int requested = window < rounds ? window : rounds;
+    send_draws(sockets, requested);
+    int current = 0;
+
+    for (int round = 1; round <= rounds; ) {
+        int count = requested;
+        receive_draws(sockets, batch[current], count);
+        int left = rounds - (round - 1) - count;
+        requested = left < window ? left : window;
+        if (requested > 0) {
+            send_draws(sockets, requested);
         }
 
-        // Print the draws (ranks only)
-        printf("\nChild 1 draws %s \n", format_card(cards[0]));
-        printf("\nChild 2 draws %s \n", format_card(cards[1]));
+        for (int k = 0; k < count; k++, round++) {
+            // This round's cards from both children
+            Card cards[2] = { batch[current][0][k], batch[current][1][k] };
 
-        // Determine the winner
-        if (cards[0].rank > cards[1].rank) {
-            printf("\nChild 1 Wins!\n");
-            wins[0]++;
-        } else if (cards[1].rank > cards[0].rank) {
-            printf("\nChild 2 Wins!\n");
-            wins[1]++;
-        } else { // Handle tie (show suits)
-            printf("\nChecking suits…\n");
-            printf("\nChild 1 draws suit %s %s \n", format_card(cards[0]), cards[0].suit);
-            printf("\nChild 2 draws suit %s %s \n", format_card(cards[1]), cards[1].suit);
-            if (suit_precedence(cards[0].suit) > suit_precedence(cards[1].suit)) {
-                printf("\nChild 1 Wins!\n");
-                wins[0]++;
-            } else {
-                printf("\nChild 2 Wins!\n");
-                wins[1]++;
+            // Determine the winner; suits only matter between equal ranks
+            int winner = cards[0].rank != cards[1].rank ? cards[1].rank > cards[0].rank
+                       : suit_precedence(cards[0].suit) > suit_precedence(cards[1].suit) ? 0 : 1;
+            wins[winner]++;
+            if (!quiet) {
+                print_round(round, cards, winner);
             }
         }
-        printf("\n---------------------------\n");
+        current = 1 - current;
     }
 
     // Check for sudden death if tied
     if (wins[0] == wins[1]) {
         printf("\nSudden Death Round!\n");
 
-        // Signal both children to draw cards
-        for (int i = 0; i < 2; i++) {
-            write(sockets[i][0], "DRAW", strlen("DRAW") + 1);
-        }
-
-        // Receive cards from both children
-        Card cards[2];
-        for (int i = 0; i < 2; i++) {
-            read(sockets[i][0], &cards[i], sizeof(Card));
-        }
+        // Ask both children for one more card
+        send_draws(sockets, 1);
+        receive_draws(sockets, batch[0], 1);
+        Card cards[2] = { batch[0][0][0], batch[0][1][0] };
 
         // Print the sudden death results (ranks only unless tied)
         printf("\nChild 1 draws %s \n", format_card(cards[0]));
@@ -216,13 +729,17 @@ int main(int argc, char *argv[]) {
 
     // Signal children to quit
     for (int i = 0; i < 2; i++) {
-        write(sockets[i][0], "QUIT", strlen("QUIT") + 1);
+        send_request(sockets[i][0], OP_QUIT, 0);
     }
 
     // Wait for threads to exit
     for (int i = 0; i < 2; i++) {
         pthread_join(threads[i], NULL);
     }
+    for (int b = 0; b < 2; b++) {
+        free(batch[b][0]);
+        free(batch[b][1]);
+    }
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+/*
+ * allocount.c - Counts heap allocations in a program it is preloaded into
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ *
+ * Built as allocount.so and loaded with LD_PRELOAD by schedbench. Every
+ * malloc-family call is counted and passed on to glibc, and the totals
+ * are written to stderr as "allocs=N bytes=M" when the program exits.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+
+// glibc's own allocator entry points, which the wrappers forward to
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void* __libc_memalign(size_t alignment, size_t size);
+
+static unsigned long long allocs;   // calls that could allocate
+static unsigned long long bytes;    // bytes asked for by those calls
+
+// Counts one call; atomic in case the program has threads
+static void count(size_t size) {
+    __atomic_add_fetch(&allocs, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&bytes, size, __ATOMIC_RELAXED);
+}
+
+void* malloc(size_t size) {
+    count(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size) {
+    count(n * size);
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    count(size);
+    return __libc_realloc(ptr, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    count(size);
+    void* mem = __libc_memalign(alignment, size);
+    if (mem == NULL) {
+        return ENOMEM;
+    }
+    *out = mem;
+    return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    count(size);
+    return __libc_memalign(alignment, size);
+}
+
+// Reports the totals with write, so reporting does not allocate
+__attribute__((destructor)) static void report(void) {
+    char line[80];
+    int n = snprintf(line, sizeof(line), "allocs=%llu bytes=%llu\n", allocs, bytes);
+    if (n > 0 && write(2, line, n) < 0) {
+        return;
+    }
+}
@@ -0,0 +1,209 @@
+/*
+ * event_log.c - Buffered formatting of scheduler events
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "event_log.h"
+#include "format_int.h"
+
+#define MAX_LINE 64     // longest line the log ever formats, start and end included
+
+// Words printed for each event code
+static const char* const event_words[] = {
+    [EV_ARRIVE] = "arriving",
+    [EV_DISPATCH] = "running",
+    [EV_PREEMPT] = "preempted",
+    [EV_RUN] = "running",
+    [EV_AGE] = "aging",
+    [EV_FINISH] = "finished",
+    [EV_SWITCH] = "switching",
+    [EV_BLOCK] = "blocked",
+    [EV_WAKE] = "waking"
+};
+
+// Makes sure another line fits in the buffer
+static void reserve_line(EventLog* log) {
+    if (log->len > EVENT_LOG_BUFFER - MAX_LINE) {
+        log_flush(log);
+    }
+}
+
+// Ends a line at p, naming the CPU first if the log shows CPUs
+static char* end_line(EventLog* log, char* p, int cpu) {
+    if (log->show_cpu) {
+        *p++ = log->sep;
+        memcpy(p, "cpu", 3);
+        p = format_int(p + 3, cpu);
+    }
+    *p++ = '\n';
+    return p;
+}
+
+// Formats "<sep>pid<sep>word[<sep>cpuN]\n" into suffix and returns its length
+static size_t format_suffix(EventLog* log, char* suffix, int pid, const char* word, int cpu) {
+    char* end = suffix;
+    *end++ = log->sep;
+    end = format_int(end, pid);
+    *end++ = log->sep;
+    size_t n = strlen(word);
+    memcpy(end, word, n);
+    end = end_line(log, end + n, cpu);
+    return (size_t)(end - suffix);
+}
+
+// Writes one line per tick in [time, end), each ending with the same suffix
+static void put_ticks(EventLog* log, int time, int end, const char* suffix, size_t n) {
+    for (int t = time; t < end; t++) {
+        reserve_line(log);
+        char* p = format_int(log->buf + log->len, t);
+        memcpy(p, suffix, n);
+        log->len = (size_t)(p - log->buf) + n;
+    }
+}
+
+/* Writes the time from time up to end as one line "time<sep>end" and the
+ * suffix, for LOG_INTERVALS; a point event has end equal to time
+ */
+static void put_interval(EventLog* log, int time, int end, const char* suffix, size_t n) {
+    reserve_line(log);
+    char* p = format_int(log->buf + log->len, time);
+    *p++ = log->sep;
+    p = format_int(p, end);
+    memcpy(p, suffix, n);
+    log->len = (size_t)(p - log->buf) + n;
+}
+
+// Creates a new event log with an empty buffer
+EventLog* log_open(FILE* out, LogLevel level, char sep, const char* idle_text) {
+    EventLog* log = (EventLog*)malloc(sizeof(EventLog));
+    char* buf = (char*)malloc(EVENT_LOG_BUFFER);
+    if (log == NULL || buf == NULL) {
+        fprintf(stderr, "Failed to allocate event log\n");
+        exit(1);
+    }
+    log->level = level;
+    log->sep = sep;
+    log->idle_text = idle_text;
+    log->show_cpu = 0;
+    log->out = out;
+    log->buf = buf;
+    log->len = 0;
+    log->written = 0;
+    return log;
+}
+
+// Formats an engine event according to the log level
+void log_event(void* ctx, int code, int time, int end, int pid, int cpu) {
+    EventLog* log = (EventLog*)ctx;
+    char suffix[MAX_LINE];
+
+    switch (code) {
+        case EV_RUN:
+        case EV_SWITCH:
+            if (log->level == LOG_FULL) {
+                put_ticks(log, time, end, suffix,
+                          format_suffix(log, suffix, pid, event_words[code], cpu));
+            } else if (log->level == LOG_INTERVALS && time < end) {
+                put_interval(log, time, end, suffix,
+                             format_suffix(log, suffix, pid, event_words[code], cpu));
+            }
+            return;
+        case EV_IDLE:
+            if ((log->level == LOG_FULL || (log->level == LOG_INTERVALS && time < end)) &&
+                log->idle_text) {
+                char* p = suffix;
+                *p++ = log->sep;
+                size_t n = strlen(log->idle_text);
+                memcpy(p, log->idle_text, n);
+                p = end_line(log, p + n, cpu);
+                if (log->level == LOG_FULL) {
+                    put_ticks(log, time, end, suffix, (size_t)(p - suffix));
+                } else {
+                    put_interval(log, time, end, suffix, (size_t)(p - suffix));
+                }
+            }
+            return;
+        case EV_DISPATCH:
+        case EV_PREEMPT:
+            // Per-tick logs already show who runs; only transitions name these
+            if (log->level != LOG_TRANSITIONS) {
+                return;
+            }
+            break;
+    }
+    if (log->level == LOG_STATS) {
+        return;
+    }
+    if (log->level == LOG_INTERVALS) {
+        put_interval(log, time, time, suffix, format_suffix(log, suffix, pid, event_words[code], cpu));
+        return;
+    }
+
+    reserve_line(log);
+    char* p = format_int(log->buf + log->len, time);
+    log->len = (size_t)(p - log->buf);
+    log->len += format_suffix(log, p, pid, event_words[code], cpu);
+}
+
+// Returns the callback the engine should report events to
+sim_event_fn log_callback(EventLog* log) {
+    return log->level == LOG_STATS ? NULL : log_event;
+}
+
+// Writes the buffered lines to the output stream, or exits if it cannot
+void log_flush(EventLog* log) {
+    if (log->len > 0) {
+        if (fwrite(log->buf, 1, log->len, log->out) != log->len) {
+            perror("event log");
+            exit(1);
+        }
+        log->written += log->len;
+        log->len = 0;
+    }
+}
+
+// Pushes everything so far out to the file, so a snapshot matches it
+long long log_snapshot(void* ctx) {
+    EventLog* log = (EventLog*)ctx;
+    log_flush(log);
+    if (fflush(log->out) != 0) {
+        perror("event log");
+        exit(1);
+    }
+    return log->written;
+}
+
+// Flushes and frees the log
+void log_close(EventLog* log) {
+    if (log == NULL) {
+        return;
+    }
+    log_flush(log);
+    free(log->buf);
+    free(log);
+}
+
+// Converts a level name to a LogLevel
+int log_parse_level(const char* name, LogLevel* level) {
+    if (strcmp(name, "full") == 0) {
+        *level = LOG_FULL;
+    } else if (strcmp(name, "transitions") == 0) {
+        *level = LOG_TRANSITIONS;
+    } else if (strcmp(name, "intervals") == 0) {
+        *level = LOG_INTERVALS;
+    } else if (strcmp(name, "stats") == 0) {
+        *level = LOG_STATS;
+    } else {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * event_log.h - prototype functions for the buffered scheduler event log
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+
+#ifndef EVENT_LOG_H_
+#define EVENT_LOG_H_
+
+#include <stdio.h>
+#include "sim_engine.h"
+
+
+#define EVENT_LOG_BUFFER (1 << 20)	// bytes formatted before each write
+
+typedef enum {
+	LOG_FULL,			// every tick: running, switching and idle lines, plus the rest
+	LOG_TRANSITIONS,	// only arrive, dispatch, preempt, age, block, wake and finish
+	LOG_STATS,			// no events at all, only the final statistics
+	LOG_INTERVALS		// what full shows, with each stretch of ticks on one
+						// "start end" line; logexpand turns it back into full
+} LogLevel;
+
+/* An event sink that formats engine events into a large buffer */
+typedef struct {
+	LogLevel level;
+	char sep;				// field separator, ' ' or '\t'
+	const char* idle_text;	// word for an idle tick, NULL to leave idle ticks out
+	int show_cpu;			// end each line with "cpuN"; off after log_open, set it
+							// for runs with more than one CPU
+	FILE* out;				// stream the buffer is written to
+	char* buf;
+	size_t len;				// bytes waiting in buf
+	long long written;		// bytes written to out so far; a caller that prints
+							// to out itself adds its own bytes
+} EventLog;
+
+
+/*
+ * creates an event log
+ * FILE* out: stream to write to; anything else printed to it must come
+ * 			after log_flush so the output stays in order
+ * LogLevel level: how much to report
+ * char sep: separator between time, pid and event
+ * const char* idle_text: printed as "time<sep>idle_text" for idle ticks
+ * 			at LOG_FULL (and LOG_INTERVALS); NULL to print nothing for them
+ * returns: a pointer to an event log
+ */
+EventLog* log_open (FILE* out, LogLevel level, char sep, const char* idle_text);
+
+/*
+ * records an engine event; matches sim_event_fn so it can be passed to
+ * the engine directly with the log as ctx
+ * returns: nothing; output is buffered until the buffer fills or
+ * 			log_flush is called
+ */
+void log_event (void* ctx, int code, int time, int end, int pid, int cpu);
+
+/*
+ * picks the engine callback for a log
+ * returns: log_event, or NULL at LOG_STATS so the engine skips
+ * 			reporting events entirely
+ */
+sim_event_fn log_callback (EventLog* log);
+
+/*
+ * writes out everything buffered so far
+ * returns: nothing; a failed write prints the error and exits
+ */
+void log_flush (EventLog* log);
+
+/*
+ * writes out everything buffered, including what out itself buffers;
+ * matches the engine's on_snapshot hook, with the log as ctx
+ * returns: the bytes of output so far
+ */
+long long log_snapshot (void* ctx);
+
+/*
+ * flushes and releases an event log
+ * EventLog* log: the log to close; may be NULL
+ * returns: nothing
+ */
+void log_close (EventLog* log);
+
+/*
+ * converts a level name given on the command line
+ * const char* name: "full", "transitions", "stats" or "intervals"
+ * LogLevel* level: receives the level
+ * returns: 0 on success, -1 if name is not a level
+ */
+int log_parse_level (const char* name, LogLevel* level);
+
+
+#endif /* EVENT_LOG_H_ */
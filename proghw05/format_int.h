@@ -0,0 +1,45 @@
+/*
+ * format_int.h - decimal formatting shared by the log and trace writers
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ *
+ * Header only, so each writer's inner loop can inline it.
+ */
+
+
+#ifndef FORMAT_INT_H_
+#define FORMAT_INT_H_
+
+#define FORMAT_INT_MAX 11	// most chars format_int writes, "-2147483648"
+
+
+/*
+ * appends a decimal integer, without snprintf's parsing of a format
+ * char* buf: where to write; needs room for FORMAT_INT_MAX chars
+ * int value: any int, INT_MIN included
+ * returns: the char after the last one written; nothing is terminated
+ */
+static inline char* format_int(char* buf, int value) {
+    char digits[FORMAT_INT_MAX];
+    int n = 0;
+    unsigned int v = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    if (value < 0) {
+        *buf++ = '-';
+    }
+    while (n > 0) {
+        *buf++ = digits[--n];
+    }
+    return buf;
+}
+
+
+#endif /* FORMAT_INT_H_ */
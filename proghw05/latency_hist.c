@@ -0,0 +1,165 @@
+/*
+ * latency_hist.c - Log-bucketed histogram for waiting, response and turnaround times
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+#include <string.h>
+#include <math.h>
+#include "latency_hist.h"
+
+#define HIST_HALF (HIST_LINEAR / 2)     // buckets per power of two above the linear range
+
+/* Bucket a value falls in
+ * Below HIST_LINEAR the value is its own bucket. Above, the value is
+ * shifted right until its top bit lands in [HIST_HALF, HIST_LINEAR), and
+ * each shift moves it up by another HIST_HALF buckets.
+ */
+static int bucket_of(int value) {
+    if (value < HIST_LINEAR) {
+        return value;
+    }
+    int shift = 31 - __builtin_clz((unsigned)value) - (HIST_SUB_BITS - 1);
+    return shift * HIST_HALF + (value >> shift);
+}
+
+// Largest value that falls in a bucket
+static int bucket_top(int bucket) {
+    if (bucket < HIST_LINEAR) {
+        return bucket;
+    }
+    int shift = bucket / HIST_HALF - 1;
+    long long top = ((long long)(bucket - shift * HIST_HALF + 1) << shift) - 1;
+    return top > 0x7fffffff ? 0x7fffffff : (int)top;
+}
+
+// Empties a histogram
+void hist_init(LatencyHist* hist) {
+    memset(hist, 0, sizeof(*hist));
+}
+
+// Counts one value
+void hist_record(LatencyHist* hist, int value) {
+    if (value < 0) {
+        value = 0;
+    }
+    if (hist->count == 0 || value < hist->min) {
+        hist->min = value;
+    }
+    if (value > hist->max) {
+        hist->max = value;
+    }
+    // Welford's update keeps the variance accurate without a sum of squares
+    hist->count++;
+    double delta = value - hist->mean;
+    hist->mean += delta / hist->count;
+    hist->m2 += delta * (value - hist->mean);
+    hist->buckets[bucket_of(value)]++;
+}
+
+// Adds one histogram's counts and moments to another
+void hist_merge(LatencyHist* into, const LatencyHist* from) {
+    if (from->count == 0) {
+        return;
+    }
+    if (into->count == 0 || from->min < into->min) {
+        into->min = from->min;
+    }
+    if (from->max > into->max) {
+        into->max = from->max;
+    }
+    // Combine the two means and spreads, weighted by their counts
+    long long count = into->count + from->count;
+    double delta = from->mean - into->mean;
+    into->m2 += from->m2 + delta * delta * ((double)into->count * from->count / count);
+    into->mean += delta * from->count / count;
+    into->count = count;
+
+    // Nothing above the maximum's bucket can be set
+    int last = bucket_of(from->max);
+    for (int b = 0; b <= last; b++) {
+        into->buckets[b] += from->buckets[b];
+    }
+}
+
+// Walks the buckets until the percentile's rank is covered
+int hist_percentile(const LatencyHist* hist, double percent) {
+    if (hist->count == 0) {
+        return 0;
+    }
+    long long rank = (long long)ceil(percent / 100.0 * hist->count);
+    if (rank < 1) {
+        rank = 1;
+    }
+    if (rank >= hist->count) {
+        return hist->max;
+    }
+    long long seen = 0;
+    int last = bucket_of(hist->max);
+    for (int b = 0; b <= last; b++) {
+        seen += hist->buckets[b];
+        if (seen >= rank) {
+            int top = bucket_top(b);
+            return top < hist->max ? top : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+// Mean of the recorded values
+double hist_mean(const LatencyHist* hist) {
+    return hist->mean;
+}
+
+// Population standard deviation from the running spread
+double hist_stddev(const LatencyHist* hist) {
+    return hist->count > 0 ? sqrt(hist->m2 / hist->count) : 0.0;
+}
+
+// The summary fields, then the count of used buckets and an index and count for each
+int hist_save(const LatencyHist* hist, FILE* out) {
+    int used = 0;
+    for (int b = 0; b < HIST_BUCKETS; b++) {
+        used += hist->buckets[b] != 0;
+    }
+    int ok = fwrite(&hist->count, sizeof(long long), 1, out) == 1 &&
+             fwrite(&hist->mean, sizeof(double), 1, out) == 1 &&
+             fwrite(&hist->m2, sizeof(double), 1, out) == 1 &&
+             fwrite(&hist->min, sizeof(int), 1, out) == 1 &&
+             fwrite(&hist->max, sizeof(int), 1, out) == 1 &&
+             fwrite(&used, sizeof(int), 1, out) == 1;
+    for (int b = 0; ok && b < HIST_BUCKETS; b++) {
+        if (hist->buckets[b] != 0) {
+            ok = fwrite(&b, sizeof(int), 1, out) == 1 &&
+                 fwrite(&hist->buckets[b], sizeof(long long), 1, out) == 1;
+        }
+    }
+    return ok ? 0 : -1;
+}
+
+// Reads the summary fields and fills in the used buckets
+int hist_load(LatencyHist* hist, FILE* in) {
+    int used;
+    hist_init(hist);
+    if (fread(&hist->count, sizeof(long long), 1, in) != 1 ||
+        fread(&hist->mean, sizeof(double), 1, in) != 1 ||
+        fread(&hist->m2, sizeof(double), 1, in) != 1 ||
+        fread(&hist->min, sizeof(int), 1, in) != 1 ||
+        fread(&hist->max, sizeof(int), 1, in) != 1 ||
+        fread(&used, sizeof(int), 1, in) != 1 || used < 0 || used > HIST_BUCKETS) {
+        return -1;
+    }
+    for (int i = 0; i < used; i++) {
+        int b;
+        if (fread(&b, sizeof(int), 1, in) != 1 || b < 0 || b >= HIST_BUCKETS ||
+            fread(&hist->buckets[b], sizeof(long long), 1, in) != 1) {
+            return -1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * latency_hist.h - prototype functions for the fixed-size latency histogram
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+
+#ifndef LATENCY_HIST_H_
+#define LATENCY_HIST_H_
+
+#include <stdio.h>
+
+
+/*
+ * Buckets are exact below HIST_LINEAR; above it each power of two is
+ * split into HIST_LINEAR / 2 buckets, so a percentile is never off by
+ * more than 1/128 of its value, for any int.
+ */
+#define HIST_SUB_BITS 8
+#define HIST_LINEAR (1 << HIST_SUB_BITS)	// values counted exactly
+#define HIST_BUCKETS (HIST_LINEAR + (31 - HIST_SUB_BITS) * (HIST_LINEAR / 2))
+
+/* A histogram of non-negative times, with a running mean and variance
+ * that stay accurate for large times; its size does not depend on how
+ * much is recorded
+ */
+typedef struct {
+	long long count;		// values recorded
+	double mean;			// of the values so far
+	double m2;				// sum of squared differences from the mean
+	int min;				// smallest value, 0 while empty
+	int max;				// largest value, 0 while empty
+	long long buckets[HIST_BUCKETS];
+} LatencyHist;
+
+
+/*
+ * empties a histogram
+ * returns: nothing
+ */
+void hist_init (LatencyHist* hist);
+
+/*
+ * counts one value
+ * int value: the time to record; negative values count as 0
+ * returns: nothing
+ */
+void hist_record (LatencyHist* hist, int value);
+
+/*
+ * adds everything recorded in one histogram to another, as if its
+ * values had been recorded there
+ * returns: nothing
+ */
+void hist_merge (LatencyHist* into, const LatencyHist* from);
+
+/*
+ * finds the value at a percentile
+ * double percent: 0 to 100; 100 gives the maximum
+ * returns: the largest value in the bucket holding that rank (never
+ * 			above the maximum), or 0 if nothing was recorded
+ */
+int hist_percentile (const LatencyHist* hist, double percent);
+
+/*
+ * returns: the mean of the recorded values, or 0 if there are none
+ */
+double hist_mean (const LatencyHist* hist);
+
+/*
+ * returns: the population standard deviation of the recorded values,
+ * 			or 0 if there are none
+ */
+double hist_stddev (const LatencyHist* hist);
+
+/*
+ * writes a histogram to a binary stream; only buckets that hold values
+ * are written, so a histogram of a few distinct times stays small
+ * returns: 0 on success, -1 if a write failed
+ */
+int hist_save (const LatencyHist* hist, FILE* out);
+
+/*
+ * reads back a histogram written by hist_save
+ * returns: 0 on success, -1 if the stream is short or malformed
+ */
+int hist_load (LatencyHist* hist, FILE* in);
+
+
+#endif /* LATENCY_HIST_H_ */
@@ -0,0 +1,154 @@
+/*
+ * logexpand.c - Expands an interval event log back into one line per tick
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ *
+ * A log written with "-l intervals" has one "start<sep>end<sep>..." line
+ * per stretch of ticks instead of a line per tick. Each such line becomes
+ * a line "t<sep>..." for every tick t from start up to end, or the single
+ * line "start<sep>..." when end equals start (an arrival, a finish). Every
+ * other line, such as the header and the statistics, is copied as it is,
+ * so the output is byte for byte what "-l full" prints for the same run,
+ * from either simulator.
+ */
+
+#define _POSIX_C_SOURCE 200809L     // getline
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "format_int.h"
+
+#define OUT_BUFFER (1 << 20)    // bytes formatted before each write
+
+/* Output formatted into a large buffer, as the event log does */
+typedef struct {
+    FILE* out;
+    const char* name;       // for error messages
+    char* buf;
+    size_t len;
+} Output;
+
+// Writes out everything buffered or exits
+static void flush_output(Output* o) {
+    if (o->len > 0 && fwrite(o->buf, 1, o->len, o->out) != o->len) {
+        perror(o->name);
+        exit(1);
+    }
+    o->len = 0;
+}
+
+// Appends bytes, flushing as needed
+static void put(Output* o, const char* data, size_t n) {
+    if (o->len + n > OUT_BUFFER) {
+        flush_output(o);
+        if (n > OUT_BUFFER) {
+            if (fwrite(data, 1, n, o->out) != n) {
+                perror(o->name);
+                exit(1);
+            }
+            return;
+        }
+    }
+    memcpy(o->buf + o->len, data, n);
+    o->len += n;
+}
+
+// Reads a time at s; returns the character after it, or NULL if there is none
+static const char* parse_time(const char* s, int* value) {
+    long long v = 0;
+    const char* start = s;
+    while (*s >= '0' && *s <= '9') {
+        v = v * 10 + (*s++ - '0');
+        if (v > INT_MAX) {
+            return NULL;
+        }
+    }
+    *value = (int)v;
+    return s > start ? s : NULL;
+}
+
+/* Expands one line
+ * An interval line is two times, each followed by the same separator, a
+ * space or a tab; the rest of the line (separator included) follows each
+ * tick
+ */
+static void expand_line(Output* o, const char* line, size_t len) {
+    int start, end;
+    const char* p = parse_time(line, &start);
+    const char* q = p && (*p == ' ' || *p == '\t') ? parse_time(p + 1, &end) : NULL;
+    if (q == NULL || *q != *p || end < start) {
+        put(o, line, len);
+        return;
+    }
+
+    const char* rest = q;
+    size_t n = len - (size_t)(q - line);
+    char tick[FORMAT_INT_MAX];
+    if (end == start) {
+        end = start + 1;    // a point event is one line at its time
+    }
+    for (int t = start; t < end; t++) {
+        if (o->len + sizeof(tick) + n > OUT_BUFFER) {
+            flush_output(o);
+        }
+        char* e = format_int(tick, t);
+        put(o, tick, (size_t)(e - tick));
+        put(o, rest, n);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 3 || (argc > 1 && argv[1][0] == '-' && argv[1][1] != '\0')) {
+        fprintf(stderr, "Usage: %s [interval_log [output]]\n"
+                        "  expands a log written with -l intervals into the -l full format;\n"
+                        "  reads stdin and writes stdout unless files are named (- for either)\n",
+                argv[0]);
+        return 1;
+    }
+    const char* input = argc > 1 ? argv[1] : "-";
+    const char* output = argc > 2 ? argv[2] : "-";
+    FILE* in = strcmp(input, "-") == 0 ? stdin : fopen(input, "r");
+    if (in == NULL) {
+        perror(input);
+        return 1;
+    }
+    Output o = { stdout, strcmp(output, "-") == 0 ? "stdout" : output, NULL, 0 };
+    if (strcmp(output, "-") != 0 && (o.out = fopen(output, "w")) == NULL) {
+        perror(output);
+        return 1;
+    }
+    o.buf = (char*)malloc(OUT_BUFFER);
+    if (o.buf == NULL) {
+        fprintf(stderr, "Failed to allocate output buffer\n");
+        return 1;
+    }
+
+    char* line = NULL;
+    size_t capacity = 0;
+    ssize_t len;
+    while ((len = getline(&line, &capacity, in)) > 0) {
+        expand_line(&o, line, (size_t)len);
+    }
+    if (ferror(in)) {
+        perror(input);
+        return 1;
+    }
+    flush_output(&o);
+    if (fflush(o.out) != 0 || (o.out != stdout && fclose(o.out) != 0)) {
+        perror(o.name);
+        return 1;
+    }
+    free(line);
+    free(o.buf);
+    if (in != stdin) {
+        fclose(in);
+    }
+    return 0;
+}
@@ -0,0 +1,287 @@
+/*
+ * my_pqueue.c - Implementation of indexed priority queue functions
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "my_pqueue.h"
+
+// Allocates memory or exits, matching the queue's out-of-memory handling
+static void* pq_alloc(void* old, size_t size) {
+    void* mem = realloc(old, size);
+    if (mem == NULL) {
+        fprintf(stderr, "Failed to allocate memory for a priority queue\n");
+        exit(1);
+    }
+    return mem;
+}
+
+// Makes room for ids up to at least id
+static void grow(pqueue pq, int id) {
+    if (pq->shared) {
+        fprintf(stderr, "Id %d is out of range for a shared priority queue\n", id);
+        exit(1);
+    }
+    if (id == INT_MAX) {
+        fprintf(stderr, "Failed to allocate memory for a priority queue\n");
+        exit(1);
+    }
+    int capacity = pq->capacity > 0 ? pq->capacity : 16;
+    while (capacity <= id) {
+        // Doubling past INT_MAX would wrap; stop at the largest int instead
+        capacity = capacity > INT_MAX / 2 ? INT_MAX : capacity * 2;
+    }
+    pq->heap = pq_alloc(pq->heap, (size_t)capacity * sizeof(int));
+    pq->pos = pq_alloc(pq->pos, (size_t)capacity * sizeof(int));
+    pq->key = pq_alloc(pq->key, (size_t)capacity * sizeof(int));
+    pq->seq = pq_alloc(pq->seq, (size_t)capacity * sizeof(long));
+    for (int i = pq->capacity; i < capacity; i++) {
+        pq->pos[i] = -1;
+    }
+    pq->capacity = capacity;
+    pq->heap_capacity = capacity;
+}
+
+// Doubles the heap of a queue whose ids live in another queue's arrays
+static void grow_heap(pqueue pq) {
+    if (pq->heap_capacity == INT_MAX) {
+        fprintf(stderr, "Failed to allocate memory for a priority queue\n");
+        exit(1);
+    }
+    if (pq->heap_capacity <= 0) {
+        pq->heap_capacity = 16;
+    } else {
+        pq->heap_capacity = pq->heap_capacity > INT_MAX / 2 ? INT_MAX : pq->heap_capacity * 2;
+    }
+    pq->heap = pq_alloc(pq->heap, (size_t)pq->heap_capacity * sizeof(int));
+}
+
+// Returns nonzero if id a belongs above id b
+static int above(pqueue pq, int a, int b) {
+    if (pq->key[a] != pq->key[b]) {
+        return pq->key[a] > pq->key[b];
+    }
+    return pq->seq[a] < pq->seq[b]; // Ties go to whoever was pushed first
+}
+
+// Puts id into heap slot and records where it went
+static void place(pqueue pq, int slot, int id) {
+    pq->heap[slot] = id;
+    pq->pos[id] = slot;
+}
+
+// Moves the id in slot toward the root until the heap is ordered
+static void sift_up(pqueue pq, int slot) {
+    int id = pq->heap[slot];
+    while (slot > 0) {
+        int parent = (slot - 1) / 2;
+        if (!above(pq, id, pq->heap[parent])) {
+            break;
+        }
+        place(pq, slot, pq->heap[parent]);
+        slot = parent;
+    }
+    place(pq, slot, id);
+}
+
+// Moves the id in slot toward the leaves until the heap is ordered
+static void sift_down(pqueue pq, int slot) {
+    int id = pq->heap[slot];
+    while (1) {
+        int child = 2 * slot + 1;
+        if (child >= pq->length) {
+            break;
+        }
+        if (child + 1 < pq->length && above(pq, pq->heap[child + 1], pq->heap[child])) {
+            child++;
+        }
+        if (!above(pq, pq->heap[child], id)) {
+            break;
+        }
+        place(pq, slot, pq->heap[child]);
+        slot = child;
+    }
+    place(pq, slot, id);
+}
+
+// Creates and returns a new priority queue
+pqueue newpqueue(int capacity) {
+    pqueue pq = (pqueue)malloc(sizeof(struct pqueueS));
+    if (pq == NULL) {
+        fprintf(stderr, "Failed to create a new priority queue\n");
+        exit(1);
+    }
+    pq->heap = NULL;
+    pq->pos = NULL;
+    pq->key = NULL;
+    pq->seq = NULL;
+    pq->length = 0;
+    pq->capacity = 0;
+    pq->heap_capacity = 0;
+    pq->shared = 0;
+    pq->next_seq = 0;
+    if (capacity > 0) {
+        grow(pq, capacity - 1);
+    }
+    return pq;
+}
+
+// Creates a priority queue that uses another queue's per-id arrays
+pqueue newpqueue_shared(pqueue owner) {
+    pqueue pq = newpqueue(0);
+    pq->pos = owner->pos;
+    pq->key = owner->key;
+    pq->seq = owner->seq;
+    pq->capacity = owner->capacity;
+    pq->shared = 1;
+    return pq;
+}
+
+// Checks if the priority queue is empty
+int pq_isempty(pqueue pq) {
+    return pq->length == 0;
+}
+
+// Returns the number of ids in the priority queue
+int pq_length(pqueue pq) {
+    return pq->length;
+}
+
+// Checks if an id is in the priority queue
+int pq_contains(pqueue pq, int id) {
+    return id < pq->capacity && pq->pos[id] != -1;
+}
+
+// Adds an id behind any queued ids with the same key
+void pq_push(pqueue pq, int id, int key) {
+    if (id >= pq->capacity) {
+        grow(pq, id);
+    }
+    if (pq->length == pq->heap_capacity) {
+        grow_heap(pq);
+    }
+    pq->key[id] = key;
+    pq->seq[id] = pq->next_seq++;
+    place(pq, pq->length++, id);
+    sift_up(pq, pq->length - 1);
+}
+
+// Removes and returns the id with the highest key
+int pq_pop(pqueue pq) {
+    if (pq_isempty(pq)) {
+        return -1;
+    }
+    int top = pq->heap[0];
+    pq_remove(pq, top);
+    return top;
+}
+
+// Returns the id with the highest key without removing it
+int pq_peek(pqueue pq) {
+    if (pq_isempty(pq)) {
+        return -1;
+    }
+    return pq->heap[0];
+}
+
+// Changes the key of a queued id and restores heap order around it
+void pq_change_key(pqueue pq, int id, int key) {
+    int old = pq->key[id];
+    pq->key[id] = key;
+    if (key > old) {
+        sift_up(pq, pq->pos[id]);
+    } else if (key < old) {
+        sift_down(pq, pq->pos[id]);
+    }
+}
+
+// Removes an id from anywhere in the priority queue
+void pq_remove(pqueue pq, int id) {
+    int slot = pq->pos[id];
+    int last = pq->heap[--pq->length];
+    pq->pos[id] = -1;
+    if (slot == pq->length) {
+        return;
+    }
+
+    // Fill the hole with the last id and let it settle either way
+    place(pq, slot, last);
+    sift_up(pq, slot);
+    sift_down(pq, pq->pos[last]);
+}
+
+// Returns the id stored in a heap slot
+int pq_at(pqueue pq, int slot) {
+    return pq->heap[slot];
+}
+
+// Returns the push sequence number of a queued id
+long pq_seq(pqueue pq, int id) {
+    return pq->seq[id];
+}
+
+// Writes the length and next sequence number, then each slot's id, key and seq
+int pq_save(pqueue pq, FILE* out) {
+    int ok = fwrite(&pq->length, sizeof(int), 1, out) == 1 &&
+             fwrite(&pq->next_seq, sizeof(long), 1, out) == 1;
+    for (int slot = 0; ok && slot < pq->length; slot++) {
+        int id = pq->heap[slot];
+        ok = fwrite(&id, sizeof(int), 1, out) == 1 &&
+             fwrite(&pq->key[id], sizeof(int), 1, out) == 1 &&
+             fwrite(&pq->seq[id], sizeof(long), 1, out) == 1;
+    }
+    return ok ? 0 : -1;
+}
+
+// Refills an empty queue slot by slot, so the heap comes back as it was saved
+int pq_load(pqueue pq, FILE* in) {
+    int length;
+    long next_seq;
+    if (!pq_isempty(pq) || fread(&length, sizeof(int), 1, in) != 1 ||
+        fread(&next_seq, sizeof(long), 1, in) != 1 || length < 0) {
+        return -1;
+    }
+    for (int slot = 0; slot < length; slot++) {
+        int id, key;
+        long seq;
+        if (fread(&id, sizeof(int), 1, in) != 1 || fread(&key, sizeof(int), 1, in) != 1 ||
+            fread(&seq, sizeof(long), 1, in) != 1 || id < 0 ||
+            (pq->shared && id >= pq->capacity) || pq_contains(pq, id)) {
+            return -1;
+        }
+        if (id >= pq->capacity) {
+            grow(pq, id);
+        }
+        if (slot == pq->heap_capacity) {
+            grow_heap(pq);
+        }
+        pq->key[id] = key;
+        pq->seq[id] = seq;
+        place(pq, slot, id);
+        pq->length = slot + 1;
+    }
+    pq->next_seq = next_seq;
+    return 0;
+}
+
+// Frees the priority queue and its arrays
+void pq_free(pqueue pq) {
+    if (pq == NULL) {
+        return;
+    }
+    free(pq->heap);
+    if (!pq->shared) {
+        free(pq->pos);
+        free(pq->key);
+        free(pq->seq);
+    }
+    free(pq);
+}
@@ -0,0 +1,168 @@
+/*
+ * my_pqueue.h - prototype functions for an indexed priority queue
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+
+#ifndef MY_PQUEUE_H_
+#define MY_PQUEUE_H_
+
+#include <stdio.h>
+
+
+/*
+ * A binary max-heap of integer ids (e.g. indexes into a process table).
+ * Each id carries an integer key; the id with the highest key is on top.
+ * Ties go to the id that was pushed first, so a ready queue keyed on
+ * priority lets the process that has waited longest win.
+ * pos[] maps an id back to its heap slot so keys can change in place.
+ * Queues made with newpqueue_shared borrow pos, key and seq from another
+ * queue, so a group of queues an id is in at most one of at a time (such
+ * as per-CPU ready queues) needs only one set of per-id arrays.
+ */
+struct pqueueS {
+	int* heap;			// ids in heap order
+	int* pos;			// heap slot of each id, -1 if not queued
+	int* key;			// key of each id
+	long* seq;			// push order of each id, smaller was pushed first
+	int length;			// number of ids in the heap
+	int capacity;		// ids 0..capacity-1 can be stored
+	int heap_capacity;	// slots in heap
+	int shared;			// pos, key and seq belong to another queue
+	long next_seq;		// sequence number for the next push
+};
+
+typedef struct pqueueS* pqueue;	// a priority queue is a pointer
+
+
+/*
+ * creates a priority queue
+ * int capacity: initial number of ids; the queue grows past it as needed
+ * returns: a pointer to a priority queue
+ */
+pqueue newpqueue (int capacity);
+
+/*
+ * creates a priority queue that shares its per-id arrays with another
+ * pqueue owner: the queue whose arrays are used; it must already have
+ * 			room for every id that will be pushed, must outlive this
+ * 			queue, and no id may be in both queues at once
+ * returns: a pointer to a priority queue; pq_contains reports ids queued
+ * 			in any queue of the group
+ */
+pqueue newpqueue_shared (pqueue owner);
+
+/*
+ * checks the status of a priority queue
+ * pqueue pq: a priority queue to check; pq must not be NULL
+ * returns: value is > 0 iff queue has no ids
+ */
+int pq_isempty (pqueue pq);
+
+/*
+ * reports how many ids are in a priority queue
+ * pqueue pq: a priority queue to check; pq must not be NULL
+ * returns: number of ids in the queue
+ */
+int pq_length (pqueue pq);
+
+/*
+ * checks whether an id is queued
+ * pqueue pq: a priority queue to check; pq must not be NULL
+ * int id: a non-negative id
+ * returns: value is > 0 iff id is in the queue
+ */
+int pq_contains (pqueue pq, int id);
+
+/*
+ * adds an id to a priority queue
+ * pqueue pq: a priority queue; pq must not be NULL
+ * int id: a non-negative id that is not already queued
+ * int key: ordering key, higher keys come out first
+ * returns: nothing; id is behind every queued id with the same key
+ */
+void pq_push (pqueue pq, int id, int key);
+
+/*
+ * removes the top id from a priority queue
+ * pqueue pq: a priority queue; pq must not be NULL
+ * returns: id with the highest key, or -1 if the queue is empty
+ */
+int pq_pop (pqueue pq);
+
+/*
+ * allows the top id to be examined
+ * pqueue pq: a priority queue; pq must not be NULL
+ * returns: id with the highest key, or -1 if the queue is empty;
+ * 			queue is left unaltered
+ */
+int pq_peek (pqueue pq);
+
+/*
+ * changes the key of a queued id in place (increase or decrease)
+ * pqueue pq: a priority queue; pq must not be NULL
+ * int id: an id currently in the queue
+ * int key: the new key
+ * returns: nothing; id keeps its place among ties
+ */
+void pq_change_key (pqueue pq, int id, int key);
+
+/*
+ * removes an arbitrary id from a priority queue
+ * pqueue pq: a priority queue; pq must not be NULL
+ * int id: an id currently in the queue
+ * returns: nothing
+ */
+void pq_remove (pqueue pq, int id);
+
+/*
+ * allows ids to be visited without removing them
+ * pqueue pq: a priority queue; pq must not be NULL
+ * int slot: 0 <= slot < pq_length(pq)
+ * returns: id stored in that heap slot; slots are in heap order,
+ * 			not in key order
+ */
+int pq_at (pqueue pq, int slot);
+
+/*
+ * reports when an id was pushed relative to the other queued ids
+ * pqueue pq: a priority queue; pq must not be NULL
+ * int id: an id currently in the queue
+ * returns: push sequence number, smaller means queued longer
+ */
+long pq_seq (pqueue pq, int id);
+
+/*
+ * writes a priority queue's contents to a binary stream: its ids in heap
+ * order with their keys and push order, so pq_load rebuilds the same heap
+ * pqueue pq: a priority queue; pq must not be NULL
+ * FILE* out: stream to write to
+ * returns: 0 on success, -1 if a write failed
+ */
+int pq_save (pqueue pq, FILE* out);
+
+/*
+ * reads back a priority queue written by pq_save
+ * pqueue pq: an empty priority queue; a shared queue must already have
+ * 			room for every id in the stream
+ * FILE* in: stream to read from
+ * returns: 0 on success, -1 if the stream is short or does not hold a
+ * 			queue that fits pq
+ */
+int pq_load (pqueue pq, FILE* in);
+
+/*
+ * releases a priority queue
+ * pqueue pq: a priority queue to free; may be NULL
+ * returns: nothing
+ */
+void pq_free (pqueue pq);
+
+
+#endif /* MY_PQUEUE_H_ */
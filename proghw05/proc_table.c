@@ -0,0 +1,242 @@
+/*
+ * proc_table.c - Struct-of-arrays process table kept in a single arena
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include "proc_table.h"
+
+#define INT_COLUMNS 8       // int columns, from pid through last_aged_at
+#define TRACE_COLUMNS 3     // pid, arrival_time and cpu_time, never written by a run
+#define COLUMN_ALIGN 64     // each column starts on its own cache line
+
+// Bytes a column of capacity elements of size bytes takes, padded
+static size_t column_size(int capacity, size_t size) {
+    return ((size_t)capacity * size + COLUMN_ALIGN - 1) & ~(size_t)(COLUMN_ALIGN - 1);
+}
+
+// Collects the int columns so they can be handled in a loop
+static void int_columns(ProcTable* table, int** columns[INT_COLUMNS]) {
+    columns[0] = &table->pid;
+    columns[1] = &table->arrival_time;
+    columns[2] = &table->cpu_time;
+    columns[3] = &table->remaining_time;
+    columns[4] = &table->priority;
+    columns[5] = &table->start_time;
+    columns[6] = &table->completion_time;
+    columns[7] = &table->last_aged_at;
+}
+
+/* Allocates an arena for capacity processes and points the columns from
+ * first on into it; the columns before first are left alone
+ */
+static int layout(ProcTable* table, int capacity, int first) {
+    if (capacity < 1) {
+        capacity = 1;
+    }
+    if ((size_t)capacity > (SIZE_MAX / INT_COLUMNS - COLUMN_ALIGN) / sizeof(int)) {
+        return -1;
+    }
+    size_t ints = column_size(capacity, sizeof(int));
+    char* arena = NULL;
+    if (posix_memalign((void**)&arena, COLUMN_ALIGN,
+                       ints * (INT_COLUMNS - first) + column_size(capacity, 1)) != 0) {
+        return -1;
+    }
+
+    int** columns[INT_COLUMNS];
+    int_columns(table, columns);
+    for (int c = first; c < INT_COLUMNS; c++) {
+        *columns[c] = (int*)(arena + (c - first) * ints);
+    }
+    table->flags = (unsigned char*)(arena + (INT_COLUMNS - first) * ints);
+    table->arena = arena;
+    table->capacity = capacity;
+    return 0;
+}
+
+// Creates an empty table
+int proc_table_init(ProcTable* table, int capacity) {
+    table->count = 0;
+    table->first_burst = NULL;
+    table->io_time = NULL;
+    table->bursts = NULL;
+    table->num_bursts = 0;
+    table->bursts_capacity = 0;
+    table->owns_bursts = 0;
+    return layout(table, capacity, 0);
+}
+
+// Resizes a per-process burst column, keeping its contents
+static int grow_column(int** column, int capacity) {
+    int* grown = (int*)realloc(*column, (size_t)(capacity > 0 ? capacity : 1) * sizeof(int));
+    if (grown == NULL) {
+        return -1;
+    }
+    *column = grown;
+    return 0;
+}
+
+// Copies the table into a new arena of the given size
+int proc_table_reserve(ProcTable* table, int capacity) {
+    ProcTable old = *table;
+    if (capacity < table->count) {
+        return -1;
+    }
+    if (table->first_burst != NULL &&
+        (grow_column(&table->first_burst, capacity) != 0 ||
+         grow_column(&table->io_time, capacity) != 0)) {
+        return -1;
+    }
+    old.first_burst = table->first_burst;
+    old.io_time = table->io_time;
+    if (layout(table, capacity, 0) != 0) {
+        *table = old;
+        return -1;
+    }
+
+    int** from[INT_COLUMNS];
+    int** to[INT_COLUMNS];
+    int_columns(&old, from);
+    int_columns(table, to);
+    for (int c = 0; c < INT_COLUMNS; c++) {
+        memcpy(*to[c], *from[c], (size_t)table->count * sizeof(int));
+    }
+    memcpy(table->flags, old.flags, (size_t)table->count);
+    free(old.arena);
+    return 0;
+}
+
+// Appends a process and sets its simulation state to not started
+int proc_table_add(ProcTable* table, int pid, int arrival, int cpu_time, int priority) {
+    int i = table->count++;
+    table->pid[i] = pid;
+    table->arrival_time[i] = arrival;
+    table->cpu_time[i] = cpu_time;
+    table->remaining_time[i] = cpu_time;
+    table->priority[i] = priority;
+    table->start_time[i] = -1;          // -1 indicates not started
+    table->completion_time[i] = -1;     // -1 indicates not completed
+    table->last_aged_at[i] = -1;
+    table->flags[i] = 0;
+    if (table->first_burst != NULL) {
+        table->first_burst[i] = -1;     // -1 indicates one CPU burst
+        table->io_time[i] = 0;
+    }
+    return i;
+}
+
+/* Appends a process's bursts to the burst list
+ * The burst columns are made the first time, for the whole capacity,
+ * with every process before this one marked as a single CPU burst.
+ */
+int proc_table_set_bursts(ProcTable* table, int id, const int* lengths, int count) {
+    long long cpu_time = 0;
+    long long io_time = 0;
+    for (int b = 0; b < count; b++) {
+        if (b % 2 == 0) {
+            cpu_time += lengths[b];
+        } else {
+            io_time += lengths[b];
+        }
+    }
+    if (cpu_time > INT_MAX || io_time > INT_MAX) {
+        return -1;
+    }
+    if (table->first_burst == NULL) {
+        if (grow_column(&table->first_burst, table->capacity) != 0 ||
+            grow_column(&table->io_time, table->capacity) != 0) {
+            return -1;
+        }
+        memset(table->first_burst, 0xff, (size_t)table->capacity * sizeof(int));
+        memset(table->io_time, 0, (size_t)table->capacity * sizeof(int));
+        table->owns_bursts = 1;
+    }
+    if (count + 1 > table->bursts_capacity - table->num_bursts) {
+        int capacity = table->bursts_capacity > 0 ? table->bursts_capacity : 64;
+        while (count + 1 > capacity - table->num_bursts) {
+            if (capacity > INT_MAX / 2) {
+                return -1;
+            }
+            capacity *= 2;
+        }
+        if (grow_column(&table->bursts, capacity) != 0) {
+            return -1;
+        }
+        table->bursts_capacity = capacity;
+    }
+
+    int* list = table->bursts + table->num_bursts;
+    list[0] = count;
+    for (int b = 0; b < count; b++) {
+        list[b + 1] = lengths[b];
+    }
+    table->first_burst[id] = table->num_bursts;
+    table->num_bursts += count + 1;
+    table->cpu_time[id] = (int)cpu_time;
+    table->remaining_time[id] = lengths[0];
+    table->io_time[id] = (int)io_time;
+    return 0;
+}
+
+/* Borrows the trace's read-only columns and resets the rest
+ * The arena only holds the columns a run writes, and is kept between
+ * binds unless the next trace is bigger.
+ */
+int proc_table_bind(ProcTable* run, const ProcTable* trace) {
+    int count = trace->count;
+    if (run->arena == NULL || run->capacity < count) {
+        void* old = run->arena;
+        if (layout(run, count, TRACE_COLUMNS) != 0) {
+            return -1;
+        }
+        free(old);
+    }
+    run->count = count;
+    run->pid = trace->pid;
+    run->arrival_time = trace->arrival_time;
+    run->cpu_time = trace->cpu_time;
+    memcpy(run->remaining_time, trace->cpu_time, (size_t)count * sizeof(int));
+    memcpy(run->priority, trace->priority, (size_t)count * sizeof(int));
+    // All bits set is -1, the not started / not completed value
+    memset(run->start_time, 0xff, (size_t)count * sizeof(int));
+    memset(run->completion_time, 0xff, (size_t)count * sizeof(int));
+    memset(run->last_aged_at, 0xff, (size_t)count * sizeof(int));
+    memset(run->flags, 0, (size_t)count);
+
+    // Processes with bursts start on their first one
+    run->first_burst = trace->first_burst;
+    run->io_time = trace->io_time;
+    run->bursts = trace->bursts;
+    run->num_bursts = trace->num_bursts;
+    run->bursts_capacity = trace->bursts_capacity;
+    run->owns_bursts = 0;
+    for (int i = 0; run->first_burst != NULL && i < count; i++) {
+        if (run->first_burst[i] != -1) {
+            run->remaining_time[i] = run->bursts[run->first_burst[i] + 1];
+        }
+    }
+    return 0;
+}
+
+// Releases the arena, and with it every column, and any bursts of its own
+void proc_table_free(ProcTable* table) {
+    if (table->owns_bursts) {
+        free(table->first_burst);
+        free(table->io_time);
+        free(table->bursts);
+    }
+    free(table->arena);
+    memset(table, 0, sizeof(*table));
+}
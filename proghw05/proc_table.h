@@ -0,0 +1,102 @@
+/*
+ * proc_table.h - prototype functions for the struct-of-arrays process table
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+
+#ifndef PROC_TABLE_H_
+#define PROC_TABLE_H_
+
+
+#define PROC_PREEMPTED 0x1	// flags bit: process was preempted at least once
+
+/* Process table
+ * One column per field of a process control block, all carved out of a
+ * single arena so the table is one allocation and one free. Processes
+ * are identified by their index, which is what the queues hold.
+ */
+typedef struct {
+	int count;				// processes in the table
+	int capacity;			// processes the arena has room for
+	int* pid;				// Process identifier
+	int* arrival_time;		// Time when process arrives in system
+	int* cpu_time;			// Total CPU time needed
+	int* remaining_time;	// CPU time still needed to complete
+	int* priority;			// Process priority (used in PP scheduling)
+	int* start_time;		// Time when process first gets CPU (-1 if not started)
+	int* completion_time;	// Time when process completes (-1 if not completed)
+	int* last_aged_at;		// Time its current aging interval began
+	unsigned char* flags;	// PROC_ bits
+	void* arena;			// backing memory for every column
+
+	// Processes that alternate CPU and I/O bursts. These columns are NULL
+	// until a process is given bursts, and are only read by a run
+	int* first_burst;		// index in bursts of its burst count, -1 for one CPU burst
+	int* io_time;			// total time it spends blocked on I/O
+	int* bursts;			// per such process: the number of bursts, then their
+							// lengths, CPU and I/O alternating, CPU first and last
+	int num_bursts;			// ints of bursts in use
+	int bursts_capacity;	// ints bursts has room for
+	int owns_bursts;		// the burst columns are this table's to free
+} ProcTable;
+
+
+/*
+ * creates an empty process table
+ * ProcTable* table: the table to set up
+ * int capacity: processes to make room for
+ * returns: 0 on success, -1 if the arena could not be allocated
+ */
+int proc_table_init (ProcTable* table, int capacity);
+
+/*
+ * moves a table into an arena of a different size
+ * ProcTable* table: the table to resize
+ * int capacity: new room; must be at least table->count
+ * returns: 0 on success, -1 if the arena could not be allocated (the
+ * 			table is left as it was)
+ */
+int proc_table_reserve (ProcTable* table, int capacity);
+
+/*
+ * appends a process read from a trace; the table must have room for it
+ * returns: the new process's index
+ */
+int proc_table_add (ProcTable* table, int pid, int arrival, int cpu_time, int priority);
+
+/*
+ * gives a process a run of CPU and I/O bursts instead of one CPU burst
+ * int id: a process already in the table
+ * const int* lengths: burst lengths, CPU and I/O alternating, CPU first
+ * int count: an odd number of bursts, at least 3
+ * returns: 0 on success, -1 if memory ran out or either total does not
+ * 			fit in an int; cpu_time becomes the total of the CPU bursts and
+ * 			remaining_time the first one
+ */
+int proc_table_set_bursts (ProcTable* table, int id, const int* lengths, int count);
+
+/*
+ * gets a table ready to simulate a loaded trace without copying it, so
+ * several runs can share one trace; call again before each run
+ * ProcTable* run: a table zeroed with memset, or one bound before; its
+ * 			pid, arrival_time and cpu_time columns and its bursts become
+ * 			the trace's, and it must not be passed to proc_table_reserve
+ * const ProcTable* trace: the loaded trace, which is only read
+ * returns: 0 on success, -1 if the run's columns could not be allocated
+ */
+int proc_table_bind (ProcTable* run, const ProcTable* trace);
+
+/*
+ * releases a process table
+ * returns: nothing; the table is left empty
+ */
+void proc_table_free (ProcTable* table);
+
+
+#endif /* PROC_TABLE_H_ */
@@ -0,0 +1,308 @@
+/*
+ * schedbench.c - Times the schedulers on generated traces of growing size
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define MAX_VALUES 16       // most sizes, policies or programs per run
+#define OUTPUT_LIMIT 4096   // bytes of a child's stderr kept for parsing
+
+// What one run of a scheduler measured
+typedef struct {
+    const char* status;     // "ok", "timeout" or "failed"
+    double wall;            // seconds
+    long long ticks;        // simulated time
+    long long events;       // event times the engine stopped at
+    long max_rss;           // peak resident set, KiB
+    long long allocs;       // -1 if allocount.so was not loaded
+} Result;
+
+// Prints how to run the benchmark
+static void usage(void) {
+    fprintf(stderr, "Usage: schedbench [-o results.csv] [-d trace_dir] [-n sizes] [-p policies]\n"
+                    "                  [-t seconds] [-r arrival_spec] [program...]\n"
+                    "  sizes and policies are comma separated (default 100 to 10000000, FCFS,PP)\n"
+                    "  programs default to ./scheduler and ./workingscheduler, and may carry their\n"
+                    "  own options, as in \"./scheduler --dynamic\"\n"
+                    "  a program that takes over -t seconds (default 120) is not run on bigger traces\n");
+}
+
+// Splits a comma separated list in place
+static int split(char* list, char** values) {
+    int n = 0;
+    for (char* tok = strtok(list, ","); tok != NULL && n < MAX_VALUES; tok = strtok(NULL, ",")) {
+        values[n++] = tok;
+    }
+    return n;
+}
+
+// Seconds on a clock that only moves forward
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Runs a program and waits for it
+ * Its stdout goes to /dev/null and its stderr is collected into err.
+ * preload: library to LD_PRELOAD, or NULL
+ * limit: seconds before the program is killed, or 0 for no limit
+ * returns: the Result, with status and wall time filled in
+ */
+static Result run(char* const* args, const char* preload, double limit,
+                  char* err, size_t err_size) {
+    Result result = { "failed", 0.0, -1, -1, 0, -1 };
+    int fds[2];
+    size_t err_len = 0;
+    err[0] = '\0';
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        exit(1);
+    }
+
+    double start = now_seconds();
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        exit(1);
+    }
+    if (pid == 0) {
+        int null = open("/dev/null", O_WRONLY);
+        dup2(null, STDOUT_FILENO);
+        dup2(fds[1], STDERR_FILENO);
+        close(fds[0]);
+        if (preload != NULL) {
+            setenv("LD_PRELOAD", preload, 1);
+        }
+        execv(args[0], args);
+        fprintf(stderr, "%s: %s\n", args[0], strerror(errno));
+        _exit(127);
+    }
+    close(fds[1]);
+
+    // Collect stderr until the child closes it or runs out of time
+    int timed_out = 0;
+    for (;;) {
+        int wait_ms = -1;
+        if (limit > 0) {
+            double left = start + limit - now_seconds();
+            if (left <= 0) {
+                kill(pid, SIGKILL);
+                timed_out = 1;
+                break;
+            }
+            wait_ms = (int)(left * 1000) + 1;
+        }
+        struct pollfd pfd = { fds[0], POLLIN, 0 };
+        if (poll(&pfd, 1, wait_ms) <= 0) {
+            continue;
+        }
+        char buf[512];
+        ssize_t n = read(fds[0], buf, sizeof(buf));
+        if (n <= 0) {
+            break;
+        }
+        size_t keep = (size_t)n < err_size - 1 - err_len ? (size_t)n : err_size - 1 - err_len;
+        memcpy(err + err_len, buf, keep);
+        err_len += keep;
+        err[err_len] = '\0';
+    }
+    close(fds[0]);
+
+    int status;
+    struct rusage usage;
+    while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {
+    }
+    result.wall = now_seconds() - start;
+    result.max_rss = usage.ru_maxrss;
+    if (timed_out) {
+        result.status = "timeout";
+    } else if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        result.status = "ok";
+    }
+    return result;
+}
+
+// Makes a trace of jobs processes in dir unless one is already there
+static void make_trace(const char* dir, long jobs, const char* arrivals, char* path, size_t size) {
+    struct stat st;
+    snprintf(path, size, "%s/trace_%ld.bin", dir, jobs);
+    if (stat(path, &st) == 0) {
+        return;
+    }
+    char count[24];
+    char err[OUTPUT_LIMIT];
+    snprintf(count, sizeof(count), "%ld", jobs);
+    char* args[] = { "./tracegen", "-b", "-s", "1", "-n", count, "--arrivals",
+                     (char*)arrivals, path, NULL };
+    Result r = run(args, NULL, 0, err, sizeof(err));
+    if (strcmp(r.status, "ok") != 0) {
+        fprintf(stderr, "Could not generate %s:\n%s", path, err);
+        exit(1);
+    }
+}
+
+// Short name for a program path
+static const char* base_name(const char* path) {
+    const char* slash = strrchr(path, '/');
+    return slash != NULL ? slash + 1 : path;
+}
+
+// Rate of count per second, or 0 when either is unknown
+static double per_second(long long count, double seconds) {
+    return count >= 0 && seconds > 0 ? count / seconds : 0.0;
+}
+
+int main(int argc, char *argv[]) {
+    const char* output = "bench_results.csv";
+    const char* dir = "bench_traces";
+    const char* arrivals = "poisson:0.07";
+    double limit = 120;
+    char default_sizes[] = "100,1000,10000,100000,1000000,10000000";
+    char default_policies[] = "FCFS,PP";
+    char* sizes[MAX_VALUES];
+    char* policies[MAX_VALUES];
+    char* programs[MAX_VALUES] = { "./scheduler", "./workingscheduler" };
+    int num_sizes = split(default_sizes, sizes);
+    int num_policies = split(default_policies, policies);
+    int num_programs = 2;
+
+    // Parse the options
+    int arg = 1;
+    for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+        const char* value = argv[arg + 1];
+        if (strcmp(argv[arg], "-o") == 0) {
+            output = value;
+        } else if (strcmp(argv[arg], "-d") == 0) {
+            dir = value;
+        } else if (strcmp(argv[arg], "-n") == 0) {
+            num_sizes = split(argv[arg + 1], sizes);
+        } else if (strcmp(argv[arg], "-p") == 0) {
+            num_policies = split(argv[arg + 1], policies);
+        } else if (strcmp(argv[arg], "-t") == 0) {
+            limit = atof(value);
+        } else if (strcmp(argv[arg], "-r") == 0) {
+            arrivals = value;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (arg < argc && argv[arg][0] == '-') {
+        usage();
+        return 1;
+    }
+    if (arg < argc) {
+        num_programs = 0;
+        for (; arg < argc && num_programs < MAX_VALUES; arg++) {
+            programs[num_programs++] = argv[arg];
+        }
+    }
+
+    // The allocation counter has to be named by an absolute path
+    char preload[PATH_MAX];
+    const char* counter = realpath("allocount.so", preload) != NULL ? preload : NULL;
+    if (counter == NULL) {
+        fprintf(stderr, "allocount.so not found; allocations will not be counted\n");
+    }
+    if (mkdir(dir, 0777) != 0 && errno != EEXIST) {
+        perror(dir);
+        return 1;
+    }
+    FILE* out = fopen(output, "w");
+    if (out == NULL) {
+        perror(output);
+        return 1;
+    }
+    fprintf(out, "program,policy,jobs,status,wall_s,ticks,ticks_per_s,events,events_per_s,"
+                 "peak_rss_kb,allocs,allocs_per_job\n");
+    printf("%-20s %-6s %10s %8s %10s %14s %14s %10s %10s\n", "program", "policy", "jobs",
+           "status", "wall s", "ticks/s", "events/s", "rss KiB", "allocs/job");
+
+    // Once a program and policy pair runs out of time, bigger traces
+    // would too, so they are skipped
+    int gave_up[MAX_VALUES][MAX_VALUES] = { { 0 } };
+    for (int s = 0; s < num_sizes; s++) {
+        long jobs = atol(sizes[s]);
+        char trace[PATH_MAX];
+        make_trace(dir, jobs, arrivals, trace, sizeof(trace));
+
+        for (int p = 0; p < num_programs; p++)
+        for (int q = 0; q < num_policies; q++) {
+            if (gave_up[p][q]) {
+                continue;
+            }
+            // A program's own options come before the benchmark's
+            char err[OUTPUT_LIMIT];
+            char command[PATH_MAX];
+            char* args[MAX_VALUES + 6];
+            int num_args = 0;
+            snprintf(command, sizeof(command), "%s", programs[p]);
+            for (char* word = strtok(command, " "); word != NULL && num_args < MAX_VALUES;
+                 word = strtok(NULL, " ")) {
+                args[num_args++] = word;
+            }
+            char* bench_args[] = { "-l", "stats", "--bench", policies[q], trace, NULL };
+            memcpy(args + num_args, bench_args, sizeof(bench_args));
+            Result r = run(args, counter, limit, err, sizeof(err));
+
+            // The scheduler and allocount.so each leave a line on stderr
+            const char* line = strstr(err, "bench ");
+            int processes;
+            if (line == NULL || sscanf(line, "bench processes=%d ticks=%lld events=%lld",
+                                       &processes, &r.ticks, &r.events) != 3) {
+                r.ticks = r.events = -1;
+            }
+            line = strstr(err, "allocs=");
+            if (line == NULL || sscanf(line, "allocs=%lld", &r.allocs) != 1) {
+                r.allocs = -1;
+            }
+            if (strcmp(r.status, "ok") != 0) {
+                gave_up[p][q] = 1;
+                if (strcmp(r.status, "failed") == 0) {
+                    fprintf(stderr, "%s %s on %s failed:\n%s", programs[p], policies[q], trace, err);
+                }
+            }
+
+            double allocs_per_job = r.allocs >= 0 && jobs > 0 ? (double)r.allocs / jobs : -1;
+            fprintf(out, "%s,%s,%ld,%s,%.4f,%lld,%.0f,%lld,%.0f,%ld,%lld,%.4f\n",
+                    base_name(programs[p]), policies[q], jobs, r.status, r.wall, r.ticks,
+                    per_second(r.ticks, r.wall), r.events, per_second(r.events, r.wall),
+                    r.max_rss, r.allocs, allocs_per_job);
+            printf("%-20s %-6s %10ld %8s %10.3f %14.0f %14.0f %10ld %10.4f\n",
+                   base_name(programs[p]), policies[q], jobs, r.status, r.wall,
+                   per_second(r.ticks, r.wall), per_second(r.events, r.wall),
+                   r.max_rss, allocs_per_job);
+            fflush(stdout);
+        }
+    }
+
+    if (fclose(out) != 0) {
+        perror(output);
+        return 1;
+    }
+    printf("Results written to %s\n", output);
+    return 0;
+}
@@ -0,0 +1,753 @@
+/*
+ * schedd.c - Runs a scheduling policy online, deciding on arrivals as they come in
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ *
+ * Arrivals are lines "pid burst [priority]" read from stdin, or from any
+ * number of clients of a Unix domain socket. The engine's clock follows
+ * the wall clock, one tick per -t microseconds. Each time the service
+ * wakes (input, or the engine's next deadline coming due) it reads all
+ * waiting input, moves the engine up to the current tick, admits the whole
+ * batch at once and writes the decisions back to the client that sent
+ * each process:
+ *     <wall seconds.micros> <tick> <pid> arriving|running|preempted|aging|finished [cpuN]
+ * Every -m seconds a metrics line goes to stderr with arrival and
+ * decision rates and the decision latency (wakeup to decisions written).
+ */
+
+#define _GNU_SOURCE     // accept4
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include "sim_engine.h"
+
+#define INPUT_BUFFER 65536          // bytes of partial input kept per client
+#define OUTPUT_LIMIT (64 << 20)     // a client this far behind on reading is dropped
+#define STDOUT_BUFFER (1 << 20)     // decisions kept before writing them to stdout
+#define MAX_EVENTS 64               // epoll events taken per wakeup
+#define DEFAULT_SLOTS 262144        // processes that can be live at once
+#define DEFAULT_TICK_US 1000        // wall time per engine tick
+
+// Words written for each decision, as in the event log
+static const char* const decision_words[] = {
+    [EV_ARRIVE] = "arriving",
+    [EV_DISPATCH] = "running",
+    [EV_PREEMPT] = "preempted",
+    [EV_AGE] = "aging",
+    [EV_FINISH] = "finished",
+    [EV_BLOCK] = "blocked",
+    [EV_WAKE] = "waking"
+};
+
+/* Where arrivals come from and decisions go
+ * stdin and stdout for pipe mode, or one connection of the socket
+ */
+typedef struct {
+    int in;                 // fd arrivals are read from
+    int out;                // fd decisions are written to
+    int pollable;           // in can be watched by epoll (not a regular file)
+    int done;               // no more input will come
+    int dropped;            // output is thrown away; the client is gone
+    unsigned int watching;  // epoll events registered for in, 0 if none
+    int live;               // processes sent and not yet finished
+    int* live_slots;        // their slots, hashed by the client's pid; -1 is empty
+    int live_cap;           // entries in live_slots, a power of two
+    char in_buf[INPUT_BUFFER];
+    size_t in_len;
+    char* out_buf;
+    size_t out_len;
+    size_t out_cap;
+} Client;
+
+// Everything the service keeps between wakeups
+typedef struct {
+    ProcTable procs;        // one row per slot; pid holds the slot itself
+    SimConfig config;
+    SchedStats stats;
+    SimRun* run;
+    int next_event;         // when the engine next has something to do
+    int* client_pid;        // pid each slot's client gave it
+    Client** owner;         // client each slot's decisions go to
+    int* free_slots;        // slots with no live process
+    int num_free;
+    int* batch;             // slots that arrived since the last cycle
+    int batch_len;
+    Client** clients;       // every open client
+    int num_clients;
+    int max_clients;
+    long long start_ns;     // monotonic time of tick 0
+    long long tick_ns;
+    char stamp[32];         // wall time of the current cycle
+    // counts for the current metrics interval, then for the whole run
+    long long arrivals, decisions, rejected, cycles;
+    long long total_arrivals, total_decisions, total_rejected;
+    int late;               // most ticks an event was handled after it was due
+    LatencyHist latency;    // microseconds per decision cycle
+    LatencyHist total_latency;
+} Service;
+
+// Markers for the epoll entries that are not clients
+static char listen_tag, timer_tag, signal_tag;
+
+// Prints how to run the service
+static void usage(void) {
+    fprintf(stderr, "Usage: schedd [-s socket_path] [-t tick_us] [-n slots] [-m seconds] "
+                    "[-q quantum] [-a interval]\n"
+                    "              [--cpus N] [--place rr | least] [--no-steal] "
+                    "[FCFS | PP | RR | SJF | SRTF | MLFQ]\n"
+                    "  without -s, arrivals are read from stdin and decisions written to stdout\n");
+}
+
+// Allocates memory or exits
+static void* service_alloc(size_t size) {
+    void* mem = calloc(1, size > 0 ? size : 1);
+    if (mem == NULL) {
+        fprintf(stderr, "Failed to allocate memory for the service\n");
+        exit(1);
+    }
+    return mem;
+}
+
+// Nanoseconds on a clock that only moves forward
+static long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// The engine tick the wall clock is in now
+static int current_tick(const Service* svc) {
+    long long tick = (monotonic_ns() - svc->start_ns) / svc->tick_ns;
+    return tick < SIM_MAX_TIME ? (int)tick : SIM_MAX_TIME;
+}
+
+// Formats the wall time once per cycle; every decision in it shares it
+static void stamp_cycle(Service* svc) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    snprintf(svc->stamp, sizeof(svc->stamp), "%lld.%06ld",
+             (long long)ts.tv_sec, ts.tv_nsec / 1000);
+}
+
+// Watches a descriptor that is not a client for input
+static void watch(int epoll_fd, int fd, void* tag) {
+    struct epoll_event ev = { EPOLLIN, { .ptr = tag } };
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        perror("epoll_ctl");
+        exit(1);
+    }
+}
+
+// Adds a client and starts watching its input
+static Client* add_client(Service* svc, int epoll_fd, int in, int out) {
+    Client* c = (Client*)service_alloc(sizeof(Client));
+    c->in = in;
+    c->out = out;
+    c->pollable = 1;
+    c->watching = EPOLLIN;
+    struct epoll_event ev = { EPOLLIN, { .ptr = c } };
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, in, &ev) != 0) {
+        if (errno != EPERM) {
+            perror("epoll_ctl");
+            exit(1);
+        }
+        c->pollable = 0;    // a regular file; it is read on every cycle instead
+        c->watching = 0;
+    }
+    if (svc->num_clients == svc->max_clients) {
+        svc->max_clients = svc->max_clients > 0 ? svc->max_clients * 2 : 8;
+        svc->clients = (Client**)realloc(svc->clients, svc->max_clients * sizeof(Client*));
+        if (svc->clients == NULL) {
+            fprintf(stderr, "Failed to allocate memory for the service\n");
+            exit(1);
+        }
+    }
+    svc->clients[svc->num_clients++] = c;
+    return c;
+}
+
+// Writes as much pending output as the client will take without blocking
+static void flush_output(Client* c) {
+    size_t sent = 0;
+    while (sent < c->out_len) {
+        ssize_t n = write(c->out, c->out_buf + sent, c->out_len - sent);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && errno == EAGAIN && c->in != c->out) {
+            // stdout shares a terminal made non-blocking with stdin; wait it out
+            struct pollfd pfd = { c->out, POLLOUT, 0 };
+            poll(&pfd, 1, -1);
+            continue;
+        }
+        if (n < 0 && errno == EAGAIN) {
+            break;
+        }
+        if (n <= 0) {
+            c->dropped = 1;     // the reader went away
+            c->done = 1;
+            sent = c->out_len;
+            break;
+        }
+        sent += (size_t)n;
+    }
+    memmove(c->out_buf, c->out_buf + sent, c->out_len - sent);
+    c->out_len -= sent;
+}
+
+// Appends text to a client's output, dropping a client that stopped reading
+static void put_output(Client* c, const char* text, size_t n) {
+    if (c->dropped) {
+        return;
+    }
+    if (c->in != c->out && c->out_len + n > STDOUT_BUFFER) {
+        flush_output(c);    // stdout blocks instead of falling behind
+    }
+    if (c->out_len + n > c->out_cap) {
+        size_t cap = c->out_cap > 0 ? c->out_cap : 65536;
+        while (cap < c->out_len + n) {
+            cap *= 2;
+        }
+        if (cap > OUTPUT_LIMIT) {
+            fprintf(stderr, "Dropping a client that is not reading its decisions\n");
+            c->dropped = 1;
+            c->done = 1;
+            c->out_len = 0;
+            return;
+        }
+        c->out_buf = (char*)realloc(c->out_buf, cap);
+        if (c->out_buf == NULL) {
+            fprintf(stderr, "Failed to allocate memory for the service\n");
+            exit(1);
+        }
+        c->out_cap = cap;
+    }
+    memcpy(c->out_buf + c->out_len, text, n);
+    c->out_len += n;
+}
+
+/* Registers what a client still needs from epoll
+ * Input stops being watched once it is done, since an end of file stays
+ * readable and would wake the service forever; output is watched while
+ * a socket has decisions it would not take
+ */
+static void rewatch(Client* c, int epoll_fd) {
+    unsigned int want = 0;
+    if (c->pollable && !c->done) {
+        want |= EPOLLIN;
+    }
+    if (c->in == c->out && c->out_len > 0 && !c->dropped) {
+        want |= EPOLLOUT;
+    }
+    if (want == c->watching) {
+        return;
+    }
+    struct epoll_event ev = { want, { .ptr = c } };
+    int op = want == 0 ? EPOLL_CTL_DEL : c->watching == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+    if (epoll_ctl(epoll_fd, op, c->in, &ev) != 0) {
+        perror("epoll_ctl");
+        exit(1);
+    }
+    c->watching = want;
+}
+
+// Where pid's slot is, or would go, in a client's live set
+static int live_index(const Service* svc, const Client* c, int pid) {
+    unsigned int mask = (unsigned int)c->live_cap - 1;
+    unsigned int i = ((unsigned int)pid * 2654435761u) & mask;
+    while (c->live_slots[i] != -1 && svc->client_pid[c->live_slots[i]] != pid) {
+        i = (i + 1) & mask;
+    }
+    return (int)i;
+}
+
+// Nonzero if the client has a process with this pid that has not finished
+static int is_live(const Service* svc, const Client* c, int pid) {
+    return c->live_cap > 0 && c->live_slots[live_index(svc, c, pid)] != -1;
+}
+
+// Adds a slot to its client's live set, doubling the set to stay at most half full
+static void add_live(Service* svc, Client* c, int slot) {
+    if ((c->live + 1) * 2 > c->live_cap) {
+        int* old = c->live_slots;
+        int old_cap = c->live_cap;
+        c->live_cap = old_cap > 0 ? old_cap * 2 : 16;
+        c->live_slots = (int*)malloc(c->live_cap * sizeof(int));
+        if (c->live_slots == NULL) {
+            fprintf(stderr, "Failed to allocate memory for the service\n");
+            exit(1);
+        }
+        memset(c->live_slots, 0xff, c->live_cap * sizeof(int));
+        for (int i = 0; i < old_cap; i++) {
+            if (old[i] != -1) {
+                c->live_slots[live_index(svc, c, svc->client_pid[old[i]])] = old[i];
+            }
+        }
+        free(old);
+    }
+    c->live_slots[live_index(svc, c, svc->client_pid[slot])] = slot;
+    c->live++;
+}
+
+/* Takes a finished slot out of its client's live set
+ * Later entries in the same run are shifted back so lookups still find them
+ */
+static void remove_live(Service* svc, Client* c, int slot) {
+    unsigned int mask = (unsigned int)c->live_cap - 1;
+    unsigned int hole = (unsigned int)live_index(svc, c, svc->client_pid[slot]);
+    c->live_slots[hole] = -1;
+    for (unsigned int i = (hole + 1) & mask; c->live_slots[i] != -1; i = (i + 1) & mask) {
+        unsigned int home = ((unsigned int)svc->client_pid[c->live_slots[i]] * 2654435761u) & mask;
+        // Move the entry into the hole unless its home lies between the two
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            c->live_slots[hole] = c->live_slots[i];
+            c->live_slots[i] = -1;
+            hole = i;
+        }
+    }
+    c->live--;
+}
+
+// Engine callback: turns one decision into a line for the client that owns the process
+static void decide(void* ctx, int code, int time, int end, int pid, int cpu) {
+    Service* svc = (Service*)ctx;
+    if (code == EV_RUN || code == EV_IDLE || code == EV_SWITCH) {
+        return;     // only transitions are decisions
+    }
+    int slot = pid;
+    Client* c = svc->owner[slot];
+    char line[128];
+    int n = snprintf(line, sizeof(line), "%s %d %d %s", svc->stamp, time,
+                     svc->client_pid[slot], decision_words[code]);
+    if (svc->config.cpus > 1) {
+        n += snprintf(line + n, sizeof(line) - n, " cpu%d", cpu);
+    }
+    line[n++] = '\n';
+    put_output(c, line, (size_t)n);
+    svc->decisions++;
+
+    // A finished process's slot can take a new one from the next cycle on
+    if (code == EV_FINISH) {
+        remove_live(svc, c, slot);
+        svc->owner[slot] = NULL;
+        svc->free_slots[svc->num_free++] = slot;
+    }
+}
+
+/* Parses one arrival line into a free slot and adds it to the batch
+ * Bad lines, negative pids, a pid the client still has live and arrivals
+ * with no free slot are answered with an error line
+ */
+static void take_arrival(Service* svc, Client* c, char* line) {
+    int pid, burst, priority = 0;
+    char reply[160];
+    int fields = sscanf(line, "%d %d %d", &pid, &burst, &priority);
+    if (fields < 2 || pid < 0 || burst < 0 || is_live(svc, c, pid)) {
+        int n = snprintf(reply, sizeof(reply), "%s error bad arrival: %.100s\n", svc->stamp, line);
+        put_output(c, reply, (size_t)(n < (int)sizeof(reply) ? n : (int)sizeof(reply) - 1));
+        svc->rejected++;
+        return;
+    }
+    if (svc->num_free == 0) {
+        int n = snprintf(reply, sizeof(reply), "%s %d %d rejected\n", svc->stamp,
+                         current_tick(svc), pid);
+        put_output(c, reply, (size_t)n);
+        svc->rejected++;
+        return;
+    }
+
+    // The row starts over as a new process; sim_arrive sets its arrival time
+    ProcTable* procs = &svc->procs;
+    int slot = svc->free_slots[--svc->num_free];
+    procs->cpu_time[slot] = burst;
+    procs->remaining_time[slot] = burst;
+    procs->priority[slot] = priority;
+    procs->start_time[slot] = -1;
+    procs->completion_time[slot] = -1;
+    procs->flags[slot] = 0;
+    svc->client_pid[slot] = pid;
+    svc->owner[slot] = c;
+    add_live(svc, c, slot);
+    svc->batch[svc->batch_len++] = slot;
+    svc->arrivals++;
+}
+
+// Reads whatever input is waiting and parses every complete line
+static void read_input(Service* svc, Client* c) {
+    while (!c->done) {
+        ssize_t n = read(c->in, c->in_buf + c->in_len, INPUT_BUFFER - 1 - c->in_len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && errno == EAGAIN) {
+            break;
+        }
+        if (n <= 0) {
+            c->done = 1;
+        } else {
+            c->in_len += (size_t)n;
+        }
+
+        // Split off complete lines; at EOF a last unterminated line counts too
+        char* line = c->in_buf;
+        char* end = c->in_buf + c->in_len;
+        char* newline;
+        while ((newline = memchr(line, '\n', (size_t)(end - line))) != NULL) {
+            *newline = '\0';
+            if (newline > line) {
+                take_arrival(svc, c, line);
+            }
+            line = newline + 1;
+        }
+        if (c->done && line < end) {
+            *end = '\0';
+            take_arrival(svc, c, line);
+            line = end;
+        }
+        c->in_len = (size_t)(end - line);
+        memmove(c->in_buf, line, c->in_len);
+        if (c->in_len == INPUT_BUFFER - 1) {
+            c->in_len = 0;      // a line longer than the buffer is not an arrival
+        }
+
+        // A regular file is read a buffer per cycle, so time still moves
+        if (!c->pollable) {
+            break;
+        }
+    }
+}
+
+/* One decision cycle
+ * Events that came due before the current tick are handled at their own
+ * ticks; then the whole batch of arrivals is admitted at the current tick
+ * together with anything else due then, as a trace run would
+ */
+static void decide_cycle(Service* svc) {
+    int now = current_tick(svc);
+    while (svc->next_event < now) {
+        if (now - svc->next_event > svc->late) {
+            svc->late = now - svc->next_event;
+        }
+        sim_advance(svc->run, svc->next_event);
+        svc->next_event = sim_step(svc->run);
+    }
+    int arrived = svc->batch_len > 0;
+    if (arrived || svc->next_event == now) {
+        sim_advance(svc->run, now);
+        for (int i = 0; i < svc->batch_len; i++) {
+            sim_arrive(svc->run, svc->batch[i]);
+        }
+        svc->batch_len = 0;
+    }
+    // A burst of 0 is due again at once
+    while (arrived || svc->next_event == now) {
+        arrived = 0;
+        svc->next_event = sim_step(svc->run);
+    }
+}
+
+// Sets the timer for the engine's next deadline, or stops it if there is none
+static void arm_timer(Service* svc, int timer_fd) {
+    struct itimerspec when;
+    memset(&when, 0, sizeof(when));
+    if (svc->next_event != INT_MAX) {
+        long long at = svc->start_ns + svc->next_event * svc->tick_ns;
+        when.it_value.tv_sec = at / 1000000000LL;
+        when.it_value.tv_nsec = at % 1000000000LL;
+        if (when.it_value.tv_sec == 0 && when.it_value.tv_nsec == 0) {
+            when.it_value.tv_nsec = 1;  // zero would disarm the timer
+        }
+    }
+    if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &when, NULL) != 0) {
+        perror("timerfd_settime");
+        exit(1);
+    }
+}
+
+// Writes the metrics for the interval just ended and starts a new one
+static void report_metrics(Service* svc, double seconds, int live) {
+    fprintf(stderr, "metrics arrivals/s=%.0f decisions/s=%.0f cycles=%lld live=%d rejected=%lld "
+                    "latency_us p50=%d p99=%d max=%d late_ticks=%d\n",
+            svc->arrivals / seconds, svc->decisions / seconds, svc->cycles, live,
+            svc->rejected, hist_percentile(&svc->latency, 50),
+            hist_percentile(&svc->latency, 99), svc->latency.max, svc->late);
+    hist_merge(&svc->total_latency, &svc->latency);
+    hist_init(&svc->latency);
+    svc->total_arrivals += svc->arrivals;
+    svc->total_decisions += svc->decisions;
+    svc->total_rejected += svc->rejected;
+    svc->arrivals = svc->decisions = svc->rejected = svc->cycles = 0;
+    svc->late = 0;
+}
+
+// Opens the listening socket, replacing a stale one left at the path
+static int open_socket(const char* path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path is too long: %s\n", path);
+        exit(1);
+    }
+    strcpy(addr.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    unlink(path);
+    if (fd < 0 || bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        perror(path);
+        exit(1);
+    }
+    return fd;
+}
+
+int main(int argc, char* argv[]) {
+    const char* socket_path = NULL;
+    const char* policy_name = "PP";
+    int tick_us = DEFAULT_TICK_US;
+    int slots = DEFAULT_SLOTS;
+    double metrics_every = 1.0;
+    SimConfig config = { NULL, AGING_INTERVAL, QUANTUM, 0, 0, 1, PLACE_ROUND_ROBIN, 1, NULL, NULL,
+                         NULL, 0, NULL, NULL };
+
+    // Parse the options, each of which but --no-steal takes a value
+    int arg = 1;
+    for (; arg < argc && argv[arg][0] == '-'; arg++) {
+        const char* value = arg + 1 < argc ? argv[arg + 1] : "";
+        if (strcmp(argv[arg], "--no-steal") == 0) {
+            config.steal = 0;
+            continue;
+        }
+        if (strcmp(argv[arg], "-s") == 0) {
+            socket_path = value;
+        } else if (strcmp(argv[arg], "-t") == 0) {
+            tick_us = atoi(value);
+        } else if (strcmp(argv[arg], "-n") == 0) {
+            slots = atoi(value);
+        } else if (strcmp(argv[arg], "-m") == 0) {
+            metrics_every = atof(value);
+        } else if (strcmp(argv[arg], "-q") == 0) {
+            config.quantum = atoi(value);
+        } else if (strcmp(argv[arg], "-a") == 0) {
+            config.aging_interval = atoi(value);
+        } else if (strcmp(argv[arg], "--cpus") == 0) {
+            config.cpus = atoi(value);
+        } else if (strcmp(argv[arg], "--place") == 0) {
+            if (strcmp(value, "rr") == 0) {
+                config.placement = PLACE_ROUND_ROBIN;
+            } else if (strcmp(value, "least") == 0) {
+                config.placement = PLACE_LEAST_LOADED;
+            } else {
+                usage();
+                return 1;
+            }
+        } else {
+            usage();
+            return 1;
+        }
+        arg++;  // skip the option's value
+    }
+    if (arg < argc) {
+        policy_name = argv[arg++];
+    }
+    config.policy = sim_find_policy(policy_name);
+    if (arg < argc || config.policy == NULL || tick_us <= 0 || slots <= 0 ||
+        config.quantum <= 0 || config.aging_interval <= 0 ||
+        config.cpus < 1 || config.cpus > SIM_MAX_CPUS || metrics_every < 0) {
+        usage();
+        return 1;
+    }
+
+    // Every slot is a row from the start, so the policies size their
+    // per-process arrays once; pids are slots, mapped back on output
+    Service* svc = (Service*)service_alloc(sizeof(Service));
+    if (proc_table_init(&svc->procs, slots) != 0) {
+        fprintf(stderr, "Failed to allocate memory for the service\n");
+        return 1;
+    }
+    for (int slot = 0; slot < slots; slot++) {
+        proc_table_add(&svc->procs, slot, 0, 0, 0);
+    }
+    svc->client_pid = (int*)service_alloc(slots * sizeof(int));
+    svc->owner = (Client**)service_alloc(slots * sizeof(Client*));
+    svc->free_slots = (int*)service_alloc(slots * sizeof(int));
+    svc->batch = (int*)service_alloc(slots * sizeof(int));
+    for (int slot = slots - 1; slot >= 0; slot--) {
+        svc->free_slots[svc->num_free++] = slot;
+    }
+
+    int pp = strcmp(config.policy->name, "PP") == 0;
+    config.finish_last = pp;
+    config.age_by_index = pp;
+    config.on_event = decide;
+    config.ctx = svc;
+    svc->config = config;
+    svc->run = sim_open(&svc->procs, &svc->config, &svc->stats);
+    svc->next_event = INT_MAX;
+    svc->tick_ns = tick_us * 1000LL;
+    hist_init(&svc->latency);
+    hist_init(&svc->total_latency);
+
+    // One epoll set for input, the deadline timer and shutdown signals
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    sigset_t stop_signals;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &stop_signals, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    int signal_fd = signalfd(-1, &stop_signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (epoll_fd < 0 || timer_fd < 0 || signal_fd < 0) {
+        perror("schedd");
+        return 1;
+    }
+    watch(epoll_fd, timer_fd, &timer_tag);
+    watch(epoll_fd, signal_fd, &signal_tag);
+    int listen_fd = -1;
+    if (socket_path != NULL) {
+        listen_fd = open_socket(socket_path);
+        watch(epoll_fd, listen_fd, &listen_tag);
+    } else {
+        fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+        add_client(svc, epoll_fd, STDIN_FILENO, STDOUT_FILENO);
+    }
+
+    svc->start_ns = monotonic_ns();
+    long long metrics_ns = (long long)(metrics_every * 1e9);
+    long long next_metrics = svc->start_ns + metrics_ns;
+    long long interval_start = svc->start_ns;
+    int stopping = 0;
+    struct epoll_event events[MAX_EVENTS];
+
+    for (;;) {
+        // Regular files never signal readiness, so they do not wait
+        int wait_ms = -1;
+        for (int i = 0; i < svc->num_clients; i++) {
+            if (!svc->clients[i]->pollable && !svc->clients[i]->done) {
+                wait_ms = 0;
+            }
+        }
+        if (metrics_ns > 0 && wait_ms != 0) {
+            long long left = (next_metrics - monotonic_ns()) / 1000000 + 1;
+            wait_ms = left > 0 ? (int)left : 0;
+        }
+        int ready = epoll_wait(epoll_fd, events, MAX_EVENTS, wait_ms);
+        if (ready < 0 && errno != EINTR) {
+            perror("epoll_wait");
+            return 1;
+        }
+        long long woke = monotonic_ns();
+        stamp_cycle(svc);
+        long long decided = svc->decisions;
+        long long arrived = svc->arrivals;
+
+        for (int i = 0; i < ready; i++) {
+            void* tag = events[i].data.ptr;
+            if (tag == &timer_tag) {
+                unsigned long long expirations;
+                if (read(timer_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+                    perror("timerfd");
+                }
+            } else if (tag == &signal_tag) {
+                stopping = 1;
+            } else if (tag == &listen_tag) {
+                int fd;
+                while ((fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                    add_client(svc, epoll_fd, fd, fd);
+                }
+            } else {
+                Client* c = (Client*)tag;
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    read_input(svc, c);
+                }
+                if (events[i].events & EPOLLOUT) {
+                    flush_output(c);
+                }
+            }
+        }
+        for (int i = 0; i < svc->num_clients; i++) {
+            if (!svc->clients[i]->pollable) {
+                read_input(svc, svc->clients[i]);
+            }
+        }
+
+        decide_cycle(svc);
+
+        // Send the decisions, and let go of clients that are finished
+        int live = 0;
+        int open = 0;
+        for (int i = 0; i < svc->num_clients; i++) {
+            Client* c = svc->clients[i];
+            if (c->out_len > 0) {
+                flush_output(c);
+            }
+            rewatch(c, epoll_fd);
+            live += c->live;
+            if (c->done && c->live == 0 && (c->out_len == 0 || c->dropped)) {
+                if (c->in != STDIN_FILENO) {
+                    close(c->in);
+                }
+                free(c->out_buf);
+                free(c->live_slots);
+                free(c);
+                svc->clients[i--] = svc->clients[--svc->num_clients];
+                continue;
+            }
+            open++;
+        }
+        if (svc->decisions > decided || svc->arrivals > arrived) {
+            svc->cycles++;
+            hist_record(&svc->latency, (int)((monotonic_ns() - woke) / 1000));
+        }
+
+        long long now_ns = monotonic_ns();
+        if (metrics_ns > 0 && now_ns >= next_metrics) {
+            report_metrics(svc, (now_ns - interval_start) / 1e9, live);
+            interval_start = now_ns;
+            next_metrics = now_ns + metrics_ns;
+        }
+
+        // Pipe mode ends once stdin is done and everything has finished
+        if (stopping || (socket_path == NULL && open == 0)) {
+            break;
+        }
+        arm_timer(svc, timer_fd);
+    }
+
+    // Totals for the whole run; times are in ticks
+    report_metrics(svc, (monotonic_ns() - interval_start) / 1e9, 0);
+    sim_close(svc->run);
+    SchedStats* stats = &svc->stats;
+    int count = stats->num_processes > 0 ? stats->num_processes : 1;
+    fprintf(stderr, "summary arrivals=%lld decisions=%lld rejected=%lld finished=%d "
+                    "latency_us p50=%d p99=%d max=%d\n",
+            svc->total_arrivals, svc->total_decisions, svc->total_rejected,
+            stats->num_processes, hist_percentile(&svc->total_latency, 50),
+            hist_percentile(&svc->total_latency, 99), svc->total_latency.max);
+    fprintf(stderr, "summary ticks=%d avg_waiting=%.2f avg_response=%.2f avg_turnaround=%.2f "
+                    "waiting_p99=%d\n",
+            stats->total_time, stats->total_waiting_time / count,
+            stats->total_response_time / count, stats->total_turnaround_time / count,
+            hist_percentile(&stats->waiting, 99));
+    if (socket_path != NULL) {
+        unlink(socket_path);
+    }
+    return 0;
+}
@@ -0,0 +1,414 @@
+/*
+ * schedreal.c - Runs a trace as real Linux processes and compares them with the simulation
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ *
+ * Every trace entry becomes a child process, forked at its arrival time
+ * (one tick is -t microseconds of wall time), that spins until it has
+ * used its burst of CPU time; a process with I/O bursts sleeps through
+ * each of them between its CPU bursts. The children are pinned with
+ * sched_setaffinity to the first --cpus CPUs the program may use, and
+ * under PP their priorities become nice values (or SCHED_FIFO priorities
+ * with --fifo). Each child writes when it first ran and when it finished
+ * to shared memory. The same trace is then simulated with the same
+ * policy and CPU count, and the two sets of statistics are printed side
+ * by side, in ticks, with the drift of the kernel from the model. The
+ * model can be given the dispatch and switch costs the host is thought
+ * to have, to see how much of the drift they explain.
+ */
+
+#define _GNU_SOURCE     // sched_setaffinity and CPU_SET
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "sim_engine.h"
+#include "trace_loader.h"
+
+#define DEFAULT_TICK_US 10000   // wall time per tick; bursts are this many microseconds each
+#define MAX_PROCESSES 10000     // most processes one run may fork
+#define SPIN_STEP 20000         // loop iterations between CPU time checks
+#define DRIVER_FIFO_PRIORITY 99 // the driver's priority with --fifo, above every child
+
+// What a child reports about itself, in nanoseconds of CLOCK_MONOTONIC
+typedef struct {
+    long long start;        // first ran at its own priority
+    long long end;          // used up its last burst
+    long long cpu;          // CPU time it actually used
+} Measured;
+
+// Prints how to run the comparison
+static void usage(void) {
+    fprintf(stderr, "Usage: schedreal [-t tick_us] [--cpus N] [--fifo] [-q quantum] [-a interval]\n"
+                    "                 [--dispatch-cost time] [--switch-cost time]\n"
+                    "                 [-o per_process.csv] [policy] trace\n"
+                    "  policy defaults to PP; a tick is 10000 microseconds unless -t says otherwise\n");
+}
+
+// Nanoseconds on the given clock
+static long long clock_ns(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Sleeps until a time on CLOCK_MONOTONIC, in nanoseconds
+static void sleep_until(long long when) {
+    struct timespec ts = { when / 1000000000LL, when % 1000000000LL };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+/* Maps a trace priority onto the kernel's scale
+ * Higher trace priorities run first, as in PP. lowest and highest are
+ * the kernel values for the trace's lowest and highest priority.
+ */
+static int scale_priority(int priority, int min, int max, int lowest, int highest) {
+    if (max == min) {
+        return highest;
+    }
+    return lowest + (int)((long long)(priority - min) * (highest - lowest) / (max - min));
+}
+
+/* Body of one child: joins the pinned CPUs, takes its priority, then
+ * goes through its bursts, spinning until its own CPU time reaches the
+ * end of each CPU burst and sleeping through each I/O burst
+ * const int* bursts: burst lengths in ticks, CPU and I/O alternating
+ * Never returns; failures exit with status 1.
+ */
+static void run_child(Measured* m, const cpu_set_t* cpus, int policy, int priority,
+                      const int* bursts, int num_bursts, long long tick_ns) {
+    if (sched_setaffinity(0, sizeof(*cpus), cpus) != 0) {
+        _exit(1);
+    }
+    if (policy == SCHED_OTHER) {
+        struct sched_param param = { 0 };
+        if (sched_setscheduler(0, SCHED_OTHER, &param) != 0 ||
+            setpriority(PRIO_PROCESS, 0, priority) != 0) {
+            _exit(1);
+        }
+    } else {
+        struct sched_param param = { priority };
+        if (sched_setscheduler(0, policy, &param) != 0) {
+            _exit(1);
+        }
+    }
+    // Give the CPU up once so the start counts from running at the
+    // child's own priority, not the driver's
+    sched_yield();
+    m->start = clock_ns(CLOCK_MONOTONIC);
+
+    volatile unsigned spin = 0;
+    long long used = 0;
+    long long target = 0;
+    for (int b = 0; b < num_bursts; b++) {
+        if (b % 2 == 1) {
+            sleep_until(clock_ns(CLOCK_MONOTONIC) + bursts[b] * tick_ns);
+            continue;
+        }
+        target += bursts[b] * tick_ns;
+        do {
+            for (int i = 0; i < SPIN_STEP; i++) {
+                spin += i;
+            }
+            used = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+        } while (used < target);
+    }
+    m->cpu = used;
+    m->end = clock_ns(CLOCK_MONOTONIC);
+    _exit(0);
+}
+
+// Orders process indexes by arrival time, then trace order
+static const ProcTable* sort_table;
+static int by_arrival(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    int ax = sort_table->arrival_time[x], ay = sort_table->arrival_time[y];
+    return ax != ay ? (ax > ay) - (ax < ay) : (x > y) - (x < y);
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Percentile of sorted values, by the nearest rank
+static double percentile(const double* sorted, int count, double percent) {
+    int rank = (int)(percent / 100 * count + 0.999999);
+    return sorted[rank < 1 ? 0 : rank - 1];
+}
+
+// Prints one measure: simulated, measured and how far apart they are
+static void print_row(const char* name, double simulated, double measured, const char* unit) {
+    printf("%-26s %12.2f%1s %12.2f%1s %+12.2f%s\n", name, simulated, unit, measured, unit,
+           measured - simulated, unit);
+}
+
+/* Prints the mean, percentiles and maximum of one time for both runs
+ * values: the measured time of each process, sorted in place
+ */
+static void print_times(const char* title, const char* name, const LatencyHist* hist,
+                        double* values, int count) {
+    char label[64];
+    double total = 0;
+    for (int i = 0; i < count; i++) {
+        total += values[i];
+    }
+    qsort(values, count, sizeof(double), compare_doubles);
+    snprintf(label, sizeof(label), "Average %s time:", name);
+    print_row(label, hist_mean(hist), total / count, "");
+    static const double points[] = { 50, 90, 99 };
+    for (int p = 0; p < 3; p++) {
+        snprintf(label, sizeof(label), "%s time p%.0f:", title, points[p]);
+        print_row(label, hist_percentile(hist, points[p]), percentile(values, count, points[p]), "");
+    }
+    snprintf(label, sizeof(label), "%s time max:", title);
+    print_row(label, hist->max, values[count - 1], "");
+}
+
+int main(int argc, char* argv[]) {
+    const char* policy_name = "PP";
+    const char* csv_path = NULL;
+    int tick_us = DEFAULT_TICK_US;
+    int fifo = 0;
+    SimConfig config = { NULL, AGING_INTERVAL, QUANTUM, 0, 0, 1, PLACE_ROUND_ROBIN, 1, NULL, NULL,
+                         NULL, 0, NULL, NULL, 0, 0, 0 };
+
+    // Parse the options, each of which but --fifo takes a value
+    int arg = 1;
+    for (; arg < argc && argv[arg][0] == '-'; arg++) {
+        const char* value = arg + 1 < argc ? argv[arg + 1] : "";
+        if (strcmp(argv[arg], "--fifo") == 0) {
+            fifo = 1;
+            continue;
+        }
+        if (strcmp(argv[arg], "-t") == 0) {
+            tick_us = atoi(value);
+        } else if (strcmp(argv[arg], "--cpus") == 0) {
+            config.cpus = atoi(value);
+        } else if (strcmp(argv[arg], "-q") == 0) {
+            config.quantum = atoi(value);
+        } else if (strcmp(argv[arg], "-a") == 0) {
+            config.aging_interval = atoi(value);
+        } else if (strcmp(argv[arg], "--dispatch-cost") == 0) {
+            config.dispatch_cost = atoi(value);
+        } else if (strcmp(argv[arg], "--switch-cost") == 0) {
+            config.switch_cost = atoi(value);
+        } else if (strcmp(argv[arg], "-o") == 0) {
+            csv_path = value;
+        } else {
+            usage();
+            return 1;
+        }
+        arg++;  // skip the option's value
+    }
+    if (argc - arg == 2) {
+        policy_name = argv[arg++];
+    }
+    config.policy = sim_find_policy(policy_name);
+    if (argc - arg != 1 || config.policy == NULL || tick_us <= 0 || config.quantum <= 0 ||
+        config.aging_interval <= 0 || config.cpus < 1 || config.cpus > SIM_MAX_CPUS ||
+        config.dispatch_cost < 0 || config.switch_cost < 0) {
+        usage();
+        return 1;
+    }
+
+    ProcTable procs;
+    load_trace(argv[arg], 4, &procs);
+    int count = procs.count;
+    if (count == 0 || count > MAX_PROCESSES) {
+        fprintf(stderr, "Real runs take 1 to %d processes; the trace has %d\n", MAX_PROCESSES, count);
+        return 1;
+    }
+
+    // The children get the first --cpus CPUs this program may use, and
+    // the driver moves to the rest when there are any
+    cpu_set_t allowed, pinned, rest;
+    CPU_ZERO(&pinned);
+    CPU_ZERO(&rest);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        perror("sched_getaffinity");
+        return 1;
+    }
+    int taken = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &allowed)) {
+            continue;
+        }
+        if (taken < config.cpus) {
+            CPU_SET(cpu, &pinned);
+            taken++;
+        } else {
+            CPU_SET(cpu, &rest);
+        }
+    }
+    if (taken < config.cpus) {
+        fprintf(stderr, "--cpus %d asks for more CPUs than the %d available\n", config.cpus, taken);
+        return 1;
+    }
+    if (CPU_COUNT(&rest) > 0) {
+        sched_setaffinity(0, sizeof(rest), &rest);
+    }
+
+    // Kernel priority of each process. Only PP reads the trace's
+    // priorities; other policies run everything at one priority
+    int kernel_policy = SCHED_OTHER;
+    if (fifo) {
+        kernel_policy = strcmp(config.policy->name, "RR") == 0 ? SCHED_RR : SCHED_FIFO;
+        struct sched_param param = { DRIVER_FIFO_PRIORITY };
+        if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+            perror("--fifo needs root or CAP_SYS_NICE: sched_setscheduler");
+            return 1;
+        }
+    }
+    int min = procs.priority[0], max = procs.priority[0];
+    for (int i = 1; i < count; i++) {
+        min = procs.priority[i] < min ? procs.priority[i] : min;
+        max = procs.priority[i] > max ? procs.priority[i] : max;
+    }
+    if (!config.policy->uses_priority) {
+        min = max;
+    }
+    int* kernel_priority = (int*)malloc(count * sizeof(int));
+    int* trace_priority = (int*)malloc(count * sizeof(int));
+    int* order = (int*)malloc(count * sizeof(int));
+    Measured* measured = (Measured*)mmap(NULL, count * sizeof(Measured), PROT_READ | PROT_WRITE,
+                                         MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (kernel_priority == NULL || trace_priority == NULL || order == NULL || measured == MAP_FAILED) {
+        fprintf(stderr, "Failed to allocate memory for %d processes\n", count);
+        return 1;
+    }
+    for (int i = 0; i < count; i++) {
+        // FIFO priorities 1 to 98 stay under the driver; nice 19 to 0
+        // only lower priority, which needs no privilege
+        kernel_priority[i] = fifo ? scale_priority(procs.priority[i], min, max, 1, DRIVER_FIFO_PRIORITY - 1)
+                                  : scale_priority(procs.priority[i], min, max, 19, 0);
+        trace_priority[i] = procs.priority[i];
+        order[i] = i;
+    }
+    sort_table = &procs;
+    qsort(order, count, sizeof(int), by_arrival);
+
+    // Fork each process at its arrival time
+    long long tick_ns = tick_us * 1000LL;
+    pid_t* children = (pid_t*)malloc(count * sizeof(pid_t));
+    fflush(NULL);
+    long long t0 = clock_ns(CLOCK_MONOTONIC);
+    for (int n = 0; n < count; n++) {
+        int i = order[n];
+        sleep_until(t0 + procs.arrival_time[i] * tick_ns);
+        children[n] = fork();
+        if (children[n] < 0) {
+            perror("fork");
+            return 1;
+        }
+        if (children[n] == 0) {
+            if (procs.first_burst != NULL && procs.first_burst[i] != -1) {
+                const int* list = procs.bursts + procs.first_burst[i];
+                run_child(&measured[i], &pinned, kernel_policy, kernel_priority[i],
+                          list + 1, list[0], tick_ns);
+            } else {
+                run_child(&measured[i], &pinned, kernel_policy, kernel_priority[i],
+                          &procs.cpu_time[i], 1, tick_ns);
+            }
+        }
+    }
+    int failed = 0;
+    for (int n = 0; n < count; n++) {
+        int status;
+        while (waitpid(children[n], &status, 0) < 0 && errno == EINTR) {
+        }
+        failed += !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+    }
+    if (failed > 0) {
+        fprintf(stderr, "%d processes could not set their CPUs or priority\n", failed);
+        return 1;
+    }
+    if (fifo) {
+        struct sched_param param = { 0 };
+        sched_setscheduler(0, SCHED_OTHER, &param);
+    }
+
+    // Simulate the same trace
+    SchedStats stats;
+    int pp = strcmp(config.policy->name, "PP") == 0;
+    config.finish_last = pp;
+    config.age_by_index = pp;
+    sim_run(&procs, &config, &stats);
+
+    // Measured times in ticks; waiting leaves out the CPU time each
+    // child really used, which runs a little over its burst, and the
+    // time it was meant to spend on I/O
+    double* waiting = (double*)malloc(count * sizeof(double));
+    double* response = (double*)malloc(count * sizeof(double));
+    double* turnaround = (double*)malloc(count * sizeof(double));
+    double cpu_used = 0, makespan = 0;
+    for (int i = 0; i < count; i++) {
+        long long arrival = t0 + procs.arrival_time[i] * tick_ns;
+        response[i] = (double)(measured[i].start - arrival) / tick_ns;
+        turnaround[i] = (double)(measured[i].end - arrival) / tick_ns;
+        waiting[i] = turnaround[i] - (double)measured[i].cpu / tick_ns;
+        if (procs.io_time != NULL) {
+            waiting[i] -= procs.io_time[i];
+        }
+        cpu_used += (double)measured[i].cpu / tick_ns;
+        makespan = turnaround[i] + procs.arrival_time[i] > makespan ? turnaround[i] + procs.arrival_time[i]
+                                                                      : makespan;
+    }
+
+    if (csv_path != NULL) {
+        FILE* csv = fopen(csv_path, "w");
+        if (csv == NULL) {
+            perror(csv_path);
+            return 1;
+        }
+        fprintf(csv, "pid,arrival,burst,priority,kernel_priority,sim_start,sim_finish,"
+                     "real_start,real_finish,real_cpu\n");
+        for (int i = 0; i < count; i++) {
+            fprintf(csv, "%d,%d,%d,%d,%d,%d,%d,%.3f,%.3f,%.3f\n", procs.pid[i], procs.arrival_time[i],
+                    procs.cpu_time[i], trace_priority[i], kernel_priority[i], procs.start_time[i],
+                    procs.completion_time[i], procs.arrival_time[i] + response[i],
+                    procs.arrival_time[i] + turnaround[i], (double)measured[i].cpu / tick_ns);
+        }
+        if (fclose(csv) != 0) {
+            perror(csv_path);
+            return 1;
+        }
+    }
+
+    printf("%s on %d CPU%s, %d processes, 1 tick = %d us, kernel policy %s\n", config.policy->name,
+           config.cpus, config.cpus > 1 ? "s" : "", count, tick_us,
+           kernel_policy == SCHED_FIFO ? "SCHED_FIFO" : kernel_policy == SCHED_RR ? "SCHED_RR"
+                                                                                  : "SCHED_OTHER");
+    printf("%-26s %13s %13s %13s\n", "", "simulated", "measured", "drift");
+    print_times("Waiting", "waiting", &stats.waiting, waiting, count);
+    print_times("Response", "response", &stats.response, response, count);
+    print_times("Turnaround", "turnaround", &stats.turnaround, turnaround, count);
+    print_row("Makespan:", stats.total_time, makespan, "");
+    print_row("Average CPU usage:", 100.0 * stats.cpu_busy_time / stats.total_time / stats.num_cpus,
+              100.0 * cpu_used / makespan / config.cpus, "%");
+
+    free(waiting);
+    free(response);
+    free(turnaround);
+    free(children);
+    free(order);
+    free(trace_priority);
+    free(kernel_priority);
+    munmap(measured, count * sizeof(Measured));
+    proc_table_free(&procs);
+    return 0;
+}
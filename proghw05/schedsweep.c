@@ -0,0 +1,492 @@
+/*
+ * schedsweep.c - Runs the scheduler simulation over a grid of settings in parallel
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "sim_engine.h"
+#include "trace_loader.h"
+#include "work_pool.h"
+
+#define MAX_VALUES 64       // most values one list option can hold
+
+// A trace loaded once and shared read-only by every run
+typedef struct {
+    const char* name;       // as given on the command line
+    ProcTable procs;
+} Trace;
+
+// Tail of one time's distribution
+typedef struct {
+    int p50;
+    int p90;
+    int p99;
+    int max;
+    double stddev;
+} Tail;
+
+// What a row reports; makespan and imbalance are -1 when they do not apply
+typedef struct {
+    long long processes;
+    double waiting;         // averages over the processes
+    double response;
+    double turnaround;
+    double cpu_usage;       // percent
+    int makespan;
+    long long migrations;
+    double imbalance;       // percent
+    Tail tails[3];          // waiting, response, turnaround
+} SweepResult;
+
+// One simulation in the sweep and what it produced
+typedef struct {
+    int trace;              // index into the traces
+    SimConfig config;
+    SweepResult result;
+} SweepRun;
+
+// Histograms of one configuration over every trace, for -m
+typedef struct {
+    pthread_mutex_t lock;   // runs on different traces finish on different threads
+    long long busy_time;
+    long long cpu_time;     // makespan times CPUs, summed
+    long long migrations;
+    LatencyHist hists[3];
+} Merged;
+
+// Everything the pool threads share
+typedef struct {
+    Trace* traces;
+    SweepRun* runs;
+    ProcTable* scratch;     // each thread's own copy of the columns a run writes
+    Merged* merged;         // one per configuration, or NULL without -m
+    int per_trace;          // runs per trace; run i is configuration i % per_trace
+} Sweep;
+
+// Prints how to run the sweep
+static void usage(void) {
+    fprintf(stderr, "Usage: schedsweep [-j threads] [-o csv | json] [-m] [-3] [-p FCFS,PP,RR,SJF,SRTF,MLFQ]\n"
+                    "                  [-q quanta] [-a aging_intervals] [--cpus counts]\n"
+                    "                  [--place rr,least] [--no-steal] trace...\n"
+                    "  lists are comma separated; every combination is run once per trace\n"
+                    "  -m adds a row per combination over all the traces together\n"
+                    "  -3 reads text traces without a priority column\n"
+                    "  use - to read a trace from stdin\n");
+}
+
+// Allocates memory or exits
+static void* sweep_alloc(size_t size) {
+    void* mem = malloc(size > 0 ? size : 1);
+    if (mem == NULL) {
+        fprintf(stderr, "Failed to allocate memory for the sweep\n");
+        exit(1);
+    }
+    return mem;
+}
+
+/* Splits a comma separated list of numbers between low and high
+ * returns: how many were read, or -1 if the list is bad
+ */
+static int parse_ints(const char* list, int* values, int low, int high) {
+    int n = 0;
+    const char* p = list;
+    for (;;) {
+        char* end;
+        long v = strtol(p, &end, 10);
+        if (end == p || v < low || v > high || n == MAX_VALUES) {
+            return -1;
+        }
+        values[n++] = (int)v;
+        if (*end == '\0') {
+            return n;
+        }
+        if (*end != ',') {
+            return -1;
+        }
+        p = end + 1;
+    }
+}
+
+/* Splits a comma separated list of words, each checked by find
+ * returns: how many were read, or -1 if a word was not recognized
+ */
+static int parse_words(const char* list, const void** values,
+                       const void* (*find)(const char* word)) {
+    char word[32];
+    int n = 0;
+    const char* p = list;
+    for (;;) {
+        size_t len = strcspn(p, ",");
+        if (len == 0 || len >= sizeof(word) || n == MAX_VALUES) {
+            return -1;
+        }
+        memcpy(word, p, len);
+        word[len] = '\0';
+        if ((values[n++] = find(word)) == NULL) {
+            return -1;
+        }
+        if (p[len] == '\0') {
+            return n;
+        }
+        p += len + 1;
+    }
+}
+
+// Placement names, looked up by parse_words
+static const SimPlacement placements[] = { PLACE_ROUND_ROBIN, PLACE_LEAST_LOADED };
+static const char* const placement_names[] = { "rr", "least" };
+
+static const void* find_placement(const char* word) {
+    for (int i = 0; i < 2; i++) {
+        if (strcmp(word, placement_names[i]) == 0) {
+            return &placements[i];
+        }
+    }
+    return NULL;
+}
+
+static const void* find_policy(const char* word) {
+    return sim_find_policy(word);
+}
+
+// Summarizes the tail of a distribution
+static Tail tail_of(const LatencyHist* hist) {
+    Tail tail = { hist_percentile(hist, 50), hist_percentile(hist, 90),
+                  hist_percentile(hist, 99), hist->max, hist_stddev(hist) };
+    return tail;
+}
+
+// Fills in the parts of a result that come from the three histograms
+static void summarize(SweepResult* result, const LatencyHist* hists) {
+    result->processes = hists[0].count;
+    result->waiting = hist_mean(&hists[0]);
+    result->response = hist_mean(&hists[1]);
+    result->turnaround = hist_mean(&hists[2]);
+    for (int i = 0; i < 3; i++) {
+        result->tails[i] = tail_of(&hists[i]);
+    }
+}
+
+// Runs one configuration of the sweep; called from the pool threads
+static void run_one(void* ctx, int worker, int job) {
+    Sweep* sweep = (Sweep*)ctx;
+    SweepRun* run = &sweep->runs[job];
+    SweepResult* result = &run->result;
+    ProcTable* procs = &sweep->scratch[worker];
+    SchedStats* stats = (SchedStats*)sweep_alloc(sizeof(SchedStats));   // too big for a thread's stack
+
+    if (proc_table_bind(procs, &sweep->traces[run->trace].procs) != 0) {
+        fprintf(stderr, "Failed to allocate memory for a simulation\n");
+        exit(1);
+    }
+    sim_run(procs, &run->config, stats);
+
+    LatencyHist* hists[3] = { &stats->waiting, &stats->response, &stats->turnaround };
+    int count = stats->num_processes > 0 ? stats->num_processes : 1;
+    result->processes = stats->num_processes;
+    result->waiting = stats->total_waiting_time / count;
+    result->response = stats->total_response_time / count;
+    result->turnaround = stats->total_turnaround_time / count;
+    result->cpu_usage = stats->total_time > 0
+                      ? (double)stats->cpu_busy_time / stats->total_time / stats->num_cpus * 100
+                      : 0.0;
+    result->makespan = stats->total_time;
+    result->migrations = stats->migrations;
+    result->imbalance = stats->load_imbalance * 100;
+    for (int i = 0; i < 3; i++) {
+        result->tails[i] = tail_of(hists[i]);
+    }
+
+    if (sweep->merged != NULL) {
+        Merged* merged = &sweep->merged[job % sweep->per_trace];
+        pthread_mutex_lock(&merged->lock);
+        merged->busy_time += stats->cpu_busy_time;
+        merged->cpu_time += (long long)stats->total_time * stats->num_cpus;
+        merged->migrations += stats->migrations;
+        for (int i = 0; i < 3; i++) {
+            hist_merge(&merged->hists[i], hists[i]);
+        }
+        pthread_mutex_unlock(&merged->lock);
+    }
+    free(stats);
+}
+
+// Prints a trace name as a CSV field, quoted if it needs to be
+static void print_csv_name(const char* name) {
+    if (strpbrk(name, ",\"\n") == NULL) {
+        fputs(name, stdout);
+        return;
+    }
+    putchar('"');
+    for (const char* c = name; *c != '\0'; c++) {
+        if (*c == '"') {
+            putchar('"');
+        }
+        putchar(*c);
+    }
+    putchar('"');
+}
+
+// Prints a trace name as a JSON string
+static void print_json_name(const char* name) {
+    putchar('"');
+    for (const unsigned char* c = (const unsigned char*)name; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            printf("\\%c", *c);
+        } else if (*c < 0x20) {
+            printf("\\u%04x", *c);
+        } else {
+            putchar(*c);
+        }
+    }
+    putchar('"');
+}
+
+/* Prints one result row
+ * Settings a policy does not use are left empty (CSV) or null (JSON),
+ * as is the placement with one CPU. Usage and imbalance are percentages
+ * like the scheduler prints.
+ */
+static void print_row(const char* trace, const SimConfig* c, const SweepResult* r, int json) {
+    static const char* const metrics[3] = { "waiting", "response", "turnaround" };
+    const char* none = json ? "null" : "";
+    char quantum[16];
+    char aging[16];
+    char place[16];
+    char makespan[16];
+    char imbalance[32];
+    snprintf(quantum, sizeof(quantum), "%d", c->quantum);
+    snprintf(aging, sizeof(aging), "%d", c->aging_interval);
+    snprintf(place, sizeof(place), json ? "\"%s\"" : "%s", placement_names[c->placement]);
+    snprintf(makespan, sizeof(makespan), "%d", r->makespan);
+    snprintf(imbalance, sizeof(imbalance), "%.2f", r->imbalance);
+
+    if (json) {
+        printf("{\"trace\": ");
+        print_json_name(trace);
+        printf(", \"policy\": \"%s\", \"quantum\": %s, \"aging\": %s, \"cpus\": %d, "
+               "\"placement\": %s, \"steal\": %s, \"processes\": %lld, "
+               "\"avg_waiting\": %.2f, \"avg_response\": %.2f, \"avg_turnaround\": %.2f, "
+               "\"cpu_usage\": %.2f, \"makespan\": %s, \"migrations\": %lld, "
+               "\"load_imbalance\": %s",
+               c->policy->name, c->policy->uses_quantum ? quantum : none,
+               c->policy->uses_aging ? aging : none, c->cpus, c->cpus > 1 ? place : none,
+               c->steal ? "true" : "false", r->processes, r->waiting, r->response,
+               r->turnaround, r->cpu_usage, r->makespan >= 0 ? makespan : none,
+               r->migrations, r->imbalance >= 0 ? imbalance : none);
+        for (int i = 0; i < 3; i++) {
+            const Tail* t = &r->tails[i];
+            printf(", \"%s\": {\"p50\": %d, \"p90\": %d, \"p99\": %d, \"max\": %d, "
+                   "\"stddev\": %.2f}", metrics[i], t->p50, t->p90, t->p99, t->max, t->stddev);
+        }
+        printf("}");
+    } else {
+        print_csv_name(trace);
+        printf(",%s,%s,%s,%d,%s,%d,%lld,%.2f,%.2f,%.2f,%.2f,%s,%lld,%s",
+               c->policy->name, c->policy->uses_quantum ? quantum : none,
+               c->policy->uses_aging ? aging : none, c->cpus, c->cpus > 1 ? place : none,
+               c->steal, r->processes, r->waiting, r->response, r->turnaround,
+               r->cpu_usage, r->makespan >= 0 ? makespan : none, r->migrations,
+               r->imbalance >= 0 ? imbalance : none);
+        for (int i = 0; i < 3; i++) {
+            const Tail* t = &r->tails[i];
+            printf(",%d,%d,%d,%d,%.2f", t->p50, t->p90, t->p99, t->max, t->stddev);
+        }
+        printf("\n");
+    }
+}
+
+// Seconds on a clock that only moves forward
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    int threads = work_pool_cpus();
+    int json = 0;
+    int merge = 0;
+    int steal = 1;
+    const void* policies[MAX_VALUES];
+    const void* places[MAX_VALUES] = { &placements[0] };
+    int quanta[MAX_VALUES] = { QUANTUM };
+    int agings[MAX_VALUES] = { AGING_INTERVAL };
+    int cpus[MAX_VALUES] = { 1 };
+    int num_policies = parse_words("FCFS,PP,RR,SJF,SRTF,MLFQ", policies, find_policy);
+    int num_places = 1;
+    int num_quanta = 1;
+    int num_agings = 1;
+    int num_cpus = 1;
+    int fields = 4;             // numbers per text record, as the scheduler reads them
+
+    // Parse the options; each takes a value except --no-steal, -m and -3
+    int arg = 1;
+    for (; arg < argc && argv[arg][0] == '-' && argv[arg][1] != '\0'; arg++) {
+        const char* value = arg + 1 < argc ? argv[arg + 1] : "";
+        int ok = 1;
+        if (strcmp(argv[arg], "--no-steal") == 0) {
+            steal = 0;
+            continue;
+        }
+        if (strcmp(argv[arg], "-m") == 0) {
+            merge = 1;
+            continue;
+        }
+        if (strcmp(argv[arg], "-3") == 0) {
+            fields = 3;
+            continue;
+        }
+        if (strcmp(argv[arg], "-j") == 0) {
+            threads = atoi(value);
+            ok = threads > 0;
+        } else if (strcmp(argv[arg], "-o") == 0) {
+            json = strcmp(value, "json") == 0;
+            ok = json || strcmp(value, "csv") == 0;
+        } else if (strcmp(argv[arg], "-p") == 0) {
+            ok = (num_policies = parse_words(value, policies, find_policy)) > 0;
+        } else if (strcmp(argv[arg], "-q") == 0) {
+            ok = (num_quanta = parse_ints(value, quanta, 1, 1 << 24)) > 0;
+        } else if (strcmp(argv[arg], "-a") == 0) {
+            ok = (num_agings = parse_ints(value, agings, 1, 1 << 24)) > 0;
+        } else if (strcmp(argv[arg], "--cpus") == 0) {
+            ok = (num_cpus = parse_ints(value, cpus, 1, SIM_MAX_CPUS)) > 0;
+        } else if (strcmp(argv[arg], "--place") == 0) {
+            ok = (num_places = parse_words(value, places, find_placement)) > 0;
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "Bad value for %s: %s\n", argv[arg], value);
+            usage();
+            return 1;
+        }
+        arg++;  // skip the option's value
+    }
+    if (arg == argc) {
+        usage();
+        return 1;
+    }
+
+    // Load every trace once
+    int num_traces = argc - arg;
+    Trace* traces = (Trace*)sweep_alloc(num_traces * sizeof(Trace));
+    for (int t = 0; t < num_traces; t++) {
+        traces[t].name = argv[arg + t];
+        load_trace(strcmp(traces[t].name, "-") == 0 ? NULL : traces[t].name,
+                   fields, &traces[t].procs);
+    }
+
+    // Every combination, skipping values a policy would ignore and
+    // placements that make no difference with one CPU
+    size_t most = (size_t)num_traces * num_policies * num_cpus * num_places
+                * num_quanta * num_agings;
+    SweepRun* runs = (SweepRun*)sweep_alloc(most * sizeof(SweepRun));
+    int count = 0;
+    for (int t = 0; t < num_traces; t++)
+    for (int p = 0; p < num_policies; p++)
+    for (int c = 0; c < num_cpus; c++)
+    for (int pl = 0; pl < (cpus[c] > 1 ? num_places : 1); pl++)
+    for (int q = 0; q < (((const SimPolicy*)policies[p])->uses_quantum ? num_quanta : 1); q++)
+    for (int a = 0; a < (((const SimPolicy*)policies[p])->uses_aging ? num_agings : 1); a++) {
+        const SimPolicy* policy = (const SimPolicy*)policies[p];
+        int pp = strcmp(policy->name, "PP") == 0;
+        SimConfig config = { policy, agings[a], quanta[q], pp, pp, cpus[c],
+                             *(const SimPlacement*)places[pl], steal, NULL, NULL };
+        memset(&runs[count], 0, sizeof(SweepRun));
+        runs[count].trace = t;
+        runs[count].config = config;
+        count++;
+    }
+
+    // Run them on the pool, each thread with its own scratch table
+    Sweep sweep = { traces, runs, NULL, NULL, count / num_traces };
+    sweep.scratch = (ProcTable*)sweep_alloc(threads * sizeof(ProcTable));
+    memset(sweep.scratch, 0, threads * sizeof(ProcTable));
+    if (merge) {
+        sweep.merged = (Merged*)sweep_alloc(sweep.per_trace * sizeof(Merged));
+        for (int i = 0; i < sweep.per_trace; i++) {
+            pthread_mutex_init(&sweep.merged[i].lock, NULL);
+            sweep.merged[i].busy_time = 0;
+            sweep.merged[i].cpu_time = 0;
+            sweep.merged[i].migrations = 0;
+            for (int h = 0; h < 3; h++) {
+                hist_init(&sweep.merged[i].hists[h]);
+            }
+        }
+    }
+    double start = now_seconds();
+    int used = work_pool_run(threads, count, run_one, &sweep);
+    double elapsed = now_seconds() - start;
+
+    // Rows come out in sweep order, whichever thread ran them
+    if (json) {
+        printf("[\n");
+    } else {
+        printf("trace,policy,quantum,aging,cpus,placement,steal,processes,avg_waiting,"
+               "avg_response,avg_turnaround,cpu_usage,makespan,migrations,load_imbalance");
+        for (int i = 0; i < 3; i++) {
+            const char* m = i == 0 ? "waiting" : i == 1 ? "response" : "turnaround";
+            printf(",%s_p50,%s_p90,%s_p99,%s_max,%s_stddev", m, m, m, m, m);
+        }
+        printf("\n");
+    }
+    int rows = count + (merge ? sweep.per_trace : 0);
+    for (int i = 0; i < rows; i++) {
+        if (json) {
+            printf("  ");
+        }
+        if (i < count) {
+            print_row(traces[runs[i].trace].name, &runs[i].config, &runs[i].result, json);
+        } else {
+            // Combined over all traces; a makespan or imbalance across
+            // separate traces would mean nothing
+            Merged* merged = &sweep.merged[i - count];
+            SweepResult result;
+            summarize(&result, merged->hists);
+            result.cpu_usage = merged->cpu_time > 0
+                             ? (double)merged->busy_time / merged->cpu_time * 100 : 0.0;
+            result.makespan = -1;
+            result.migrations = merged->migrations;
+            result.imbalance = -1;
+            print_row("all", &runs[i - count].config, &result, json);
+        }
+        if (json) {
+            printf(i + 1 < rows ? ",\n" : "\n");
+        }
+    }
+    if (json) {
+        printf("]\n");
+    }
+    fprintf(stderr, "%d simulations on %d threads in %.2f s (%.1f per second)\n",
+            count, used, elapsed, elapsed > 0 ? count / elapsed : 0.0);
+
+    for (int i = 0; i < threads; i++) {
+        proc_table_free(&sweep.scratch[i]);
+    }
+    for (int t = 0; t < num_traces; t++) {
+        proc_table_free(&traces[t].procs);
+    }
+    if (merge) {
+        for (int i = 0; i < sweep.per_trace; i++) {
+            pthread_mutex_destroy(&sweep.merged[i].lock);
+        }
+        free(sweep.merged);
+    }
+    free(sweep.scratch);
+    free(runs);
+    free(traces);
+    return 0;
+}
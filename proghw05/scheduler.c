@@ -1,5 +1,5 @@
 /*
- * scheduler.c - Program to simulate a process scheduler using First-Come First-Served (FCFS) and Preemptive Priority (PP) algorithms.
+ * scheduler.c - Program to simulate a process scheduler using First-Come First-Served (FCFS), Preemptive Priority (PP), Round Robin (RR), SJF, SRTF and MLFQ algorithms.
  *
  * Author: Jacob Johnson
  * Date: 12/04/2024 
@@ -11,23 +11,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include "my_queue.h"
-
-// Process structure
-typedef struct Process {
-    int pid;
-    int arrival_time;
-    int cpu_time;
-    int priority;
-    int remaining_time;
-    int start_time;
-    int completion_time;
-    int waiting_time;
-    int response_time;
-    int last_run_time;  
-    int last_enqueued_time;
-    int last_aged_time;
-} Process;
+#include "sim_engine.h"
+#include "trace_loader.h"
+#include "event_log.h"
 
 // Process statistics
 typedef struct ProcessStats {
@@ -37,266 +23,208 @@ typedef struct ProcessStats {
     double cpu_usage;
 } ProcessStats;
 
-#define AGING_INTERVAL 8
-#define MAX_PROCESSES 25
-
 // Function prototypes
-void run_fcfs(Process processes[], int count);
-void run_pp(Process processes[], int count);
-void print_stats(Process processes[], int count, int total_time);
-
-int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: scheduler [FCFS | PP]\n");
-        return 1;
-    }
-
-    Process processes[MAX_PROCESSES];
-    int count = 0;
-    int pid, arrival_time, cpu_time, priority;
-
-    // Read the input
-    while (1) {
-        if (scanf("%d %d %d %d", &pid, &arrival_time, &cpu_time, &priority) != 4) break;
-        if (pid == 0 && arrival_time == 0 && cpu_time == 0 && priority == 0) break;
-
-        processes[count].pid = pid;
-        processes[count].arrival_time = arrival_time;
-        processes[count].cpu_time = cpu_time;
-        processes[count].remaining_time = cpu_time;
-        processes[count].priority = priority;  
-        processes[count].start_time = -1;
-        processes[count].completion_time = -1;
-        processes[count].waiting_time = 0;
-        processes[count].response_time = -1;
-        processes[count].last_run_time = -1;
-        processes[count].last_enqueued_time = -1;
-        processes[count].last_aged_time = -1;
-
-        count++;
-    }
-
-    // Run the simulation
-    printf("Simulation starting:\n");
-    if (strcmp(argv[1], "FCFS") == 0) {
-        run_fcfs(processes, count);
-    } else if (strcmp(argv[1], "PP") == 0) {
-        run_pp(processes, count);
-    } else {
-        fprintf(stderr, "Invalid scheduling algorithm\n");
-        return 1;
-    }
-
-    return 0;
+void run_policy(ProcTable* processes, SimConfig* config, LogLevel level, int bench);
+void print_stats(SchedStats* stats);
+void print_percentiles(const char* name, const LatencyHist* hist);
+
+// Prints how to run the simulator
+static void usage(void) {
+    fprintf(stderr, "Usage: scheduler [-l full | transitions | stats | intervals] [-q quantum] [-a interval]\n"
+                    "                 [--cpus N] [--place rr | least] [--no-steal]\n"
+                    "                 [--dispatch-cost time] [--switch-cost time]\n"
+                    "                 [--snapshot file] [--snapshot-every time] [--resume file]\n"
+                    "                 [--bench] [--dynamic] [FCFS | PP | RR | SJF | SRTF | MLFQ] [trace_file]\n");
 }
 
-void run_pp(Process processes[], int count) {
-    queue ready_queue = newqueue();
-    int current_time = 0;
-    int completed = 0;
-    int current_process_index = -1;
-    
-    // Initialize process timing
-    for (int i = 0; i < count; i++) {
-        processes[i].last_run_time = -1;
-        processes[i].last_enqueued_time = -1;
-        processes[i].last_aged_time = -1;
-    }
-    
-    while (completed < count) {
-        // Add new processes
-        for (int i = 0; i < count; i++) {
-            if (processes[i].arrival_time == current_time) {
-                printf("%d %d arriving\n", current_time, processes[i].pid);
-                int* index = malloc(sizeof(int));
-                *index = i;
-                processes[i].last_enqueued_time = current_time;
-                processes[i].last_run_time = -1;
-                enqueue(ready_queue, index);
-            }
+int main(int argc, char *argv[]) {
+    // Options: "-l level" picks how much of the simulation is printed,
+    // "-q quantum" sets the RR and MLFQ time slice, "-a interval" the PP
+    // aging period, "--cpus N" simulates N CPUs with arrivals queued per
+    // "--place" and idle CPUs stealing work unless "--no-steal" is given.
+    // "--dispatch-cost" and "--switch-cost" charge CPU time for every
+    // dispatch, and for every dispatch that replaces another process.
+    // "--snapshot file" keeps the run's latest state in file, taken every
+    // "--snapshot-every" ticks, and "--resume file" carries on from one.
+    // "--bench" adds a line for schedbench to stderr, and "--dynamic"
+    // runs the policy through its hook pointers instead of its kernel
+    int arg = 1;
+    int bench = 0;
+    int have_level = 0;
+    LogLevel level = LOG_FULL;
+    SimConfig config = { NULL, AGING_INTERVAL, QUANTUM, 0, 0, 1, PLACE_ROUND_ROBIN, 1, NULL, NULL,
+                         NULL, SNAPSHOT_EVERY, NULL, NULL, 0, 0, 0 };
+    for (; arg < argc && argv[arg][0] == '-'; arg++) {
+        const char* value = arg + 1 < argc ? argv[arg + 1] : "";
+        if (strcmp(argv[arg], "--no-steal") == 0) {
+            config.steal = 0;
+            continue;
         }
-
-        // Modified aging section for run_pp():
-        for (int i = 0; i < count; i++) {
-            if (processes[i].remaining_time > 0 && 
-                processes[i].arrival_time <= current_time &&
-                i != current_process_index) {
-                
-                // Calculate waiting time
-                int waiting_start;
-                if (processes[i].last_run_time == -1) {
-                    // Never run - count from arrival
-                    waiting_start = processes[i].arrival_time;
-                } else if (processes[i].last_aged_time != -1) {
-                    // Count from last aging
-                    waiting_start = processes[i].last_aged_time;
-                } else {
-                    // Count from last run
-                    waiting_start = processes[i].last_run_time;
-                }
-                
-                int waiting_time = current_time - waiting_start;
-                
-                // Age the process if it has been waiting for AGING_INTERVAL
-                if (waiting_time >= AGING_INTERVAL && 
-                    (processes[i].last_aged_time == -1 || 
-                     current_time - processes[i].last_aged_time >= AGING_INTERVAL)) {
-                    processes[i].priority++;
-                    processes[i].last_aged_time = current_time;
-                    printf("%d %d aging\n", current_time, processes[i].pid);
-                }
-            }
+        if (strcmp(argv[arg], "--bench") == 0) {
+            bench = 1;
+            continue;
         }
-
-        // Check if current process finished
-        if (current_process_index != -1 && processes[current_process_index].remaining_time == 0) {
-            printf("%d %d finished\n", current_time, processes[current_process_index].pid);
-            processes[current_process_index].completion_time = current_time;
-            completed++;
-            current_process_index = -1;
+        if (strcmp(argv[arg], "--dynamic") == 0) {
+            config.dynamic = 1;
             continue;
         }
-
-        // Select highest priority process
-        int highest_priority = current_process_index != -1 ? 
-            processes[current_process_index].priority : -1;
-        int selected_index = current_process_index;
-        
-        // Select the highest priority process
-        queue temp_queue = newqueue();
-        while (!isempty(ready_queue)) {
-            int* index = dequeue(ready_queue);
-            if (processes[*index].remaining_time > 0 && 
-                processes[*index].priority > highest_priority) {
-                if (selected_index != -1 && selected_index != current_process_index) {
-                    int* prev = malloc(sizeof(int));
-                    *prev = selected_index;
-                    enqueue(temp_queue, prev);
-                }
-                highest_priority = processes[*index].priority;
-                selected_index = *index;
+        if (strcmp(argv[arg], "-l") == 0) {
+            if (log_parse_level(value, &level) != 0) {
+                fprintf(stderr, "Log level must be full, transitions, stats or intervals\n");
+                return 1;
+            }
+            have_level = 1;
+        } else if (strcmp(argv[arg], "-q") == 0) {
+            config.quantum = atoi(value);
+            if (config.quantum <= 0) {
+                fprintf(stderr, "Quantum must be a positive number\n");
+                return 1;
+            }
+        } else if (strcmp(argv[arg], "-a") == 0) {
+            config.aging_interval = atoi(value);
+            if (config.aging_interval <= 0) {
+                fprintf(stderr, "Aging interval must be a positive number\n");
+                return 1;
+            }
+        } else if (strcmp(argv[arg], "--cpus") == 0) {
+            config.cpus = atoi(value);
+            if (config.cpus < 1 || config.cpus > SIM_MAX_CPUS) {
+                fprintf(stderr, "CPUs must be between 1 and %d\n", SIM_MAX_CPUS);
+                return 1;
+            }
+        } else if (strcmp(argv[arg], "--dispatch-cost") == 0 ||
+                   strcmp(argv[arg], "--switch-cost") == 0) {
+            int cost = atoi(value);
+            if (cost < 0 || (cost == 0 && strcmp(value, "0") != 0)) {
+                fprintf(stderr, "Dispatch and switch costs must be 0 or more\n");
+                return 1;
+            }
+            if (argv[arg][2] == 'd') {
+                config.dispatch_cost = cost;
             } else {
-                enqueue(temp_queue, index);
+                config.switch_cost = cost;
             }
-        }
-        
-        // Re-enqueue the remaining processes
-        while (!isempty(temp_queue)) {
-            enqueue(ready_queue, dequeue(temp_queue));
-        }
-
-        // Handle preemption
-        if (selected_index != current_process_index) {
-            if (current_process_index != -1) {
-                int* index = malloc(sizeof(int));
-                *index = current_process_index;
-                processes[current_process_index].last_enqueued_time = current_time;
-                enqueue(ready_queue, index);
+        } else if (strcmp(argv[arg], "--snapshot") == 0) {
+            config.snapshot = value;
+        } else if (strcmp(argv[arg], "--snapshot-every") == 0) {
+            config.snapshot_every = atoi(value);
+            if (config.snapshot_every <= 0) {
+                fprintf(stderr, "Snapshot interval must be a positive number\n");
+                return 1;
             }
-            current_process_index = selected_index;
-        }
-
-        // Run selected process
-        if (current_process_index != -1) {
-            if (processes[current_process_index].remaining_time == processes[current_process_index].cpu_time) {
-                processes[current_process_index].start_time = current_time;
-                processes[current_process_index].response_time = current_time - 
-                    processes[current_process_index].arrival_time;
+        } else if (strcmp(argv[arg], "--resume") == 0) {
+            config.resume = value;
+        } else if (strcmp(argv[arg], "--place") == 0) {
+            if (strcmp(value, "rr") == 0) {
+                config.placement = PLACE_ROUND_ROBIN;
+            } else if (strcmp(value, "least") == 0) {
+                config.placement = PLACE_LEAST_LOADED;
+            } else {
+                fprintf(stderr, "Placement must be rr or least\n");
+                return 1;
             }
-            printf("%d %d running\n", current_time, processes[current_process_index].pid);
-            processes[current_process_index].remaining_time--;
-            processes[current_process_index].last_aged_time = -1;
-            processes[current_process_index].last_run_time = current_time + 1;
+        } else {
+            usage();
+            return 1;
         }
+        arg++;  // skip the option's value
+    }
 
-        current_time++;
+    if (argc - arg != 1 && argc - arg != 2) {
+        usage();
+        return 1;
+    }
+    config.policy = sim_find_policy(argv[arg]);
+    if (config.policy == NULL) {
+        fprintf(stderr, "Invalid scheduling algorithm\n");
+        return 1;
     }
 
-    print_stats(processes, count, current_time);
-}
+    // Non-preemptive policies only print transitions by default, to keep
+    // the terminal tidy; the others print every tick to show preemption
+    if (!have_level) {
+        level = config.policy->should_preempt ? LOG_FULL : LOG_TRANSITIONS;
+    }
 
-void run_fcfs(Process processes[], int count) {
-    queue ready_queue = newqueue();
-    int current_time = 0;
-    int completed = 0;
-    int current_process_index = -1;
+    // Read the input from the named trace, or from stdin
+    ProcTable processes;
+    load_trace(argc - arg == 2 ? argv[arg + 1] : NULL, 4, &processes);
 
     // Run the simulation
-    while (completed < count) {
-        // Check for newly arrived processes
-        for (int i = 0; i < count; i++) {
-            if (processes[i].arrival_time == current_time) {
-                printf("%d %d arriving\n", current_time, processes[i].pid);
-                int* index = malloc(sizeof(int));
-                if (!index) {
-                    fprintf(stderr, "Memory allocation failed\n");
-                    exit(EXIT_FAILURE);
-                }
-                *index = i;
-                enqueue(ready_queue, index);
-            }
-        }
-
-        // Select the next process to run if no process is currently running
-        if (current_process_index == -1 && !isempty(ready_queue)) {
-            int* index = dequeue(ready_queue);
-            if (index != NULL) {
-                current_process_index = *index;
-                free(index);
+    run_policy(&processes, &config, level, bench);
 
-                // Start process execution
-                processes[current_process_index].start_time = current_time;
-                processes[current_process_index].response_time = current_time - processes[current_process_index].arrival_time;
-                printf("%d %d running\n", current_time, processes[current_process_index].pid);
-            }
-        }
-
-        // Execute the running process
-        if (current_process_index != -1) {
-            processes[current_process_index].remaining_time--;
-
-            // If the process completes
-            if (processes[current_process_index].remaining_time == 0) {
-                printf("%d %d finished\n", current_time + 1, processes[current_process_index].pid);
-                processes[current_process_index].completion_time = current_time + 1;
-                completed++;
-
-                // Calculate metrics
-                processes[current_process_index].waiting_time =
-                    processes[current_process_index].completion_time -
-                    processes[current_process_index].arrival_time -
-                    processes[current_process_index].cpu_time;
-
-                current_process_index = -1; // Reset to select the next process
-            }
-        }
+    proc_table_free(&processes);
+    return 0;
+}
 
-        current_time++;
+void run_policy(ProcTable* processes, SimConfig* config, LogLevel level, int bench) {
+    SchedStats stats;
+    EventLog* log = log_open(stdout, level, ' ', NULL);
+    log->show_cpu = config->cpus > 1;
+
+    // A resumed run picks up after everything the snapshot had printed,
+    // including the first line, and counts its output from there
+    SimSnapshotInfo info;
+    if (config->resume == NULL) {
+        log->written = printf("Simulation starting:\n");
+    } else if (sim_snapshot_info(config->resume, &info) == 0) {
+        log->written = info.output;
+        fprintf(stderr, "Resuming at time %d; output continues from byte %lld\n",
+                info.time, info.output);
     }
 
-    // print the stats
-    print_stats(processes, count, current_time);
+    // PP has always reported finishes and same-time aging after arrivals,
+    // with aging in trace order
+    int pp = strcmp(config->policy->name, "PP") == 0;
+    config->finish_last = pp;
+    config->age_by_index = pp;
+    config->on_event = log_callback(log);
+    config->ctx = log;
+    config->on_snapshot = log_snapshot;
+    sim_run(processes, config, &stats);
+    log_close(log);
+    print_stats(&stats);
+    if (bench) {
+        fprintf(stderr, "bench processes=%d ticks=%d events=%lld\n",
+                stats.num_processes, stats.total_time, stats.events);
+    }
 }
 
+void print_stats(SchedStats* stats) {
+    int count = stats->num_processes;
 
-
-void print_stats(Process processes[], int count, int total_time) {
-    double total_waiting_time = 0;
-    double total_response_time = 0;
-    double total_turnaround_time = 0;
-    int total_cpu_time = 0;
-    
-    for (int i = 0; i < count; i++) {
-        int turnaround_time = processes[i].completion_time - processes[i].arrival_time;
-        total_waiting_time += turnaround_time - processes[i].cpu_time;
-        total_response_time += processes[i].response_time;
-        total_turnaround_time += turnaround_time;
-        total_cpu_time += processes[i].cpu_time;
+    printf("Average waiting time: %.2f\n", stats->total_waiting_time / count);
+    printf("Average response time: %.2f\n", stats->total_response_time / count);
+    printf("Average turnaround time: %.2f\n", stats->total_turnaround_time / count);
+    printf("Average CPU usage: %.2f%%\n", 
+           ((double)stats->cpu_busy_time / stats->total_time / stats->num_cpus) * 100);
+    if (stats->num_cpus > 1) {
+        for (int cpu = 0; cpu < stats->num_cpus; cpu++) {
+            printf("CPU %d usage: %.2f%%\n", cpu,
+                   ((double)stats->cpu_busy[cpu] / stats->total_time) * 100);
+        }
+        printf("Migrations: %d\n", stats->migrations);
+        printf("Load imbalance: %.2f%%\n", stats->load_imbalance * 100);
     }
+    // Only runs that pay for dispatching or do I/O have more to say; CPU
+    // usage above counts dispatching as busy, useful CPU usage does not
+    if (stats->overhead_time > 0 || stats->blocks > 0) {
+        double capacity = (double)stats->total_time * stats->num_cpus;
+        printf("Useful CPU usage: %.2f%%\n",
+               (stats->cpu_busy_time - stats->overhead_time) / capacity * 100);
+        printf("Overhead: %.2f%% (%lld dispatches, %lld switches)\n",
+               stats->overhead_time / capacity * 100, stats->dispatches, stats->switches);
+        printf("I/O blocks: %lld\n", stats->blocks);
+        printf("Throughput: %.4f processes per tick\n", (double)count / stats->total_time);
+    }
+    print_percentiles("Waiting time", &stats->waiting);
+    print_percentiles("Response time", &stats->response);
+    print_percentiles("Turnaround time", &stats->turnaround);
+}
 
-    printf("Average waiting time: %.2f\n", total_waiting_time / count);
-    printf("Average response time: %.2f\n", total_response_time / count);
-    printf("Average turnaround time: %.2f\n", total_turnaround_time / count);
-    printf("Average CPU usage: %.2f%%\n", 
-           ((double)total_cpu_time / total_time) * 100);
-}
\ No newline at end of file
+// Percentiles are within 1% (exact below 256); the deviation is exact
+void print_percentiles(const char* name, const LatencyHist* hist) {
+    printf("%s: p50 %d, p90 %d, p99 %d, max %d, stddev %.2f\n", name,
+           hist_percentile(hist, 50), hist_percentile(hist, 90),
+           hist_percentile(hist, 99), hist->max, hist_stddev(hist));
+}
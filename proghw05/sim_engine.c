@@ -0,0 +1,460 @@
+/*
+ * sim_engine.c - Discrete-event scheduler simulation shared by the simulators
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <limits.h>
+#include "sim_internal.h"
+
+#define SNAPSHOT_MAGIC "SCHEDSNP"
+#define SNAPSHOT_VERSION 4
+
+// Orders arrivals by time, keeping trace order for equal times
+static int compare_arrivals(const void* a, const void* b) {
+    const Arrival* x = (const Arrival*)a;
+    const Arrival* y = (const Arrival*)b;
+    if (x->arrival_time != y->arrival_time) {
+        return x->arrival_time < y->arrival_time ? -1 : 1;
+    }
+    return x->index - y->index;
+}
+
+// Allocates memory or exits
+static void* sim_alloc(size_t size) {
+    void* mem = malloc(size > 0 ? size : 1);
+    if (mem == NULL) {
+        fprintf(stderr, "Failed to allocate memory for simulation\n");
+        exit(1);
+    }
+    return mem;
+}
+
+// Forwards an event to the configured callback
+void sim_emit(const SimConfig* config, int code, int time, int end, int pid, int cpu) {
+    if (config->on_event) {
+        config->on_event(config->ctx, code, time, end, pid, cpu);
+    }
+}
+
+/* Front of a snapshot file
+ * Like binary traces, snapshots are in the machine's own layout, and are
+ * meant to be resumed where they were written
+ */
+typedef struct {
+    char magic[8];
+    int version;
+    char policy[8];
+    int cpus;
+    int count;
+    int time;                   // clock when the snapshot was taken
+    long long output;           // bytes of output written before it
+    unsigned long long trace;   // fingerprint of the trace columns
+} SnapshotHeader;
+
+/* Where the engine is between events
+ * With the process table, statistics and policy states, this is all it
+ * takes to carry on a run
+ */
+typedef struct {
+    int next_arrival;           // position in arrival order of the next arrival
+    int next_cpu;               // next CPU for round robin placement
+    int completed;              // processes finished
+    int ids;                    // processes from this index on have not arrived
+    int running[SIM_MAX_CPUS];
+    int queued[SIM_MAX_CPUS];
+    int overhead[SIM_MAX_CPUS];
+} RunPoint;
+
+// Fingerprint of the trace, so a snapshot is only resumed on its own trace
+static unsigned long long trace_hash(const ProcTable* procs) {
+    const int* columns[] = { procs->pid, procs->arrival_time, procs->cpu_time, procs->priority };
+    unsigned long long hash = 14695981039346656037ULL;  // FNV-1a, a word at a time
+    for (int c = 0; c < 4; c++) {
+        for (int i = 0; i < procs->count; i++) {
+            hash = (hash ^ (unsigned int)columns[c][i]) * 1099511628211ULL;
+        }
+    }
+    for (int i = 0; procs->first_burst != NULL && i < procs->count; i++) {
+        if (procs->first_burst[i] != -1) {
+            const int* list = procs->bursts + procs->first_burst[i];
+            for (int b = 0; b <= list[0]; b++) {
+                hash = (hash ^ (unsigned int)list[b]) * 1099511628211ULL;
+            }
+        }
+    }
+    return hash;
+}
+
+// The process columns a run changes
+static void state_columns(const ProcTable* procs, int** columns) {
+    columns[0] = procs->remaining_time;
+    columns[1] = procs->priority;
+    columns[2] = procs->start_time;
+    columns[3] = procs->completion_time;
+    columns[4] = procs->last_aged_at;
+}
+
+/* Writes a snapshot next to the old one, then renames it into place, so
+ * a crash while writing leaves the previous snapshot intact
+ */
+void sim_save_snapshot(const SimRun* run, unsigned long long trace, int sorted) {
+    const SimConfig* config = run->config;
+    const ProcTable* procs = run->procs;
+    const SchedStats* stats = run->stats;
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, 8);
+    header.version = SNAPSHOT_VERSION;
+    strncpy(header.policy, config->policy->name, sizeof(header.policy) - 1);
+    header.cpus = config->cpus;
+    header.count = procs->count;
+    header.time = run->now;
+    header.output = config->on_snapshot ? config->on_snapshot(config->ctx) : 0;
+    header.trace = trace;
+
+    RunPoint point;
+    memset(&point, 0, sizeof(point));
+    point.next_arrival = run->next_arrival;
+    point.next_cpu = run->next_cpu;
+    point.completed = run->completed;
+    point.ids = sorted ? run->next_arrival : 0;
+    for (int i = 0; !sorted && i < run->next_arrival; i++) {
+        if (run->arrivals[i].index >= point.ids) {
+            point.ids = run->arrivals[i].index + 1;
+        }
+    }
+    for (int cpu = 0; cpu < config->cpus; cpu++) {
+        point.running[cpu] = run->running[cpu];
+        point.queued[cpu] = run->queued[cpu];
+        point.overhead[cpu] = run->overhead[cpu];
+    }
+
+    size_t len = strlen(config->snapshot);
+    char* temp = (char*)sim_alloc(len + 5);
+    memcpy(temp, config->snapshot, len);
+    strcpy(temp + len, ".tmp");
+    FILE* out = fopen(temp, "wb");
+    if (out == NULL) {
+        perror(temp);
+        exit(1);
+    }
+
+    // Statistics up to the histograms are plain numbers; the histograms
+    // only write the buckets in use
+    int* columns[5];
+    size_t ids = (size_t)point.ids;
+    state_columns(procs, columns);
+    int ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+             fwrite(&point, sizeof(point), 1, out) == 1 &&
+             fwrite(stats, offsetof(SchedStats, waiting), 1, out) == 1 &&
+             hist_save(&stats->waiting, out) == 0 &&
+             hist_save(&stats->response, out) == 0 &&
+             hist_save(&stats->turnaround, out) == 0;
+    for (int c = 0; ok && c < 5; c++) {
+        ok = fwrite(columns[c], sizeof(int), ids, out) == ids;
+    }
+    ok = ok && fwrite(procs->flags, 1, ids, out) == ids;
+    for (int cpu = 0; ok && cpu < config->cpus; cpu++) {
+        ok = config->policy->save(run->state[cpu], out, point.ids) == 0;
+    }
+    if (ok && run->blocked != NULL) {
+        ok = fwrite(run->burst_at, sizeof(int), ids, out) == ids &&
+             pq_save(run->blocked, out) == 0;
+    }
+    if (fclose(out) != 0 || !ok || rename(temp, config->snapshot) != 0) {
+        perror(config->snapshot);
+        exit(1);
+    }
+    free(temp);
+}
+
+// Reads and checks a snapshot's header; returns 0, or -1 if it has none
+static int read_header(FILE* in, SnapshotHeader* header) {
+    if (fread(header, sizeof(*header), 1, in) != 1 ||
+        memcmp(header->magic, SNAPSHOT_MAGIC, 8) != 0 || header->version != SNAPSHOT_VERSION) {
+        return -1;
+    }
+    header->policy[7] = '\0';
+    return 0;
+}
+
+// Reads where a snapshot was taken
+int sim_snapshot_info(const char* path, SimSnapshotInfo* info) {
+    SnapshotHeader header;
+    FILE* in = fopen(path, "rb");
+    if (in == NULL) {
+        return -1;
+    }
+    int ok = read_header(in, &header) == 0;
+    fclose(in);
+    if (!ok) {
+        return -1;
+    }
+    memcpy(info->policy, header.policy, sizeof(info->policy));
+    info->cpus = header.cpus;
+    info->count = header.count;
+    info->time = header.time;
+    info->output = header.output;
+    return 0;
+}
+
+/* Loads a snapshot over a run that has just been set up
+ * Everything the snapshot does not hold (processes that have not arrived,
+ * the arrival order) is already as it was at the start of the run.
+ * returns: nothing; exits if the snapshot cannot be resumed here
+ */
+static void load_snapshot(SimRun* run, unsigned long long trace) {
+    const SimConfig* config = run->config;
+    ProcTable* procs = run->procs;
+    SchedStats* stats = run->stats;
+    const char* path = config->resume;
+    FILE* in = fopen(path, "rb");
+    if (in == NULL) {
+        perror(path);
+        exit(1);
+    }
+    SnapshotHeader header;
+    if (read_header(in, &header) != 0) {
+        fprintf(stderr, "%s: not a scheduler snapshot\n", path);
+        exit(1);
+    }
+    if (strcmp(header.policy, config->policy->name) != 0 || header.cpus != config->cpus ||
+        header.count != procs->count || header.trace != trace) {
+        fprintf(stderr, "%s: snapshot of %s on %d CPU(s) over a %d process trace; "
+                        "resume it with the same policy, CPU count and trace\n",
+                path, header.policy, header.cpus, header.count);
+        exit(1);
+    }
+
+    RunPoint point;
+    int* columns[5];
+    state_columns(procs, columns);
+    int ok = fread(&point, sizeof(point), 1, in) == 1 &&
+             point.ids >= 0 && point.ids <= procs->count &&
+             point.next_arrival >= 0 && point.next_arrival <= run->num_arrivals &&
+             fread(stats, offsetof(SchedStats, waiting), 1, in) == 1 &&
+             hist_load(&stats->waiting, in) == 0 &&
+             hist_load(&stats->response, in) == 0 &&
+             hist_load(&stats->turnaround, in) == 0;
+    size_t ids = ok ? (size_t)point.ids : 0;
+    for (int c = 0; ok && c < 5; c++) {
+        ok = fread(columns[c], sizeof(int), ids, in) == ids;
+    }
+    ok = ok && fread(procs->flags, 1, ids, in) == ids;
+    for (int cpu = 0; ok && cpu < config->cpus; cpu++) {
+        ok = config->policy->load(run->state[cpu], in, point.ids) == 0;
+    }
+    if (ok && run->blocked != NULL) {
+        ok = fread(run->burst_at, sizeof(int), ids, in) == ids &&
+             pq_load(run->blocked, in) == 0;
+    }
+    if (!ok || fgetc(in) != EOF) {
+        fprintf(stderr, "%s: snapshot is damaged\n", path);
+        exit(1);
+    }
+    fclose(in);
+
+    // Which CPUs are busy or hold work follows from the counts
+    run->now = header.time;
+    run->next_arrival = point.next_arrival;
+    run->next_cpu = point.next_cpu;
+    run->completed = point.completed;
+    for (int cpu = 0; cpu < config->cpus; cpu++) {
+        run->running[cpu] = point.running[cpu];
+        run->queued[cpu] = point.queued[cpu];
+        run->overhead[cpu] = point.overhead[cpu];
+        run->waiting += point.queued[cpu];
+        run->num_busy += point.running[cpu] != -1;
+        track(&run->active, &run->busy, cpu, point.running[cpu], point.queued[cpu]);
+    }
+}
+
+/* The engine loop for policies without a kernel of their own, or with
+ * config->dynamic set: every hook is called through the policy's
+ * pointers, the optional ones are checked for at each use, and one CPU
+ * takes the same path as many
+ */
+#define POLICY (run->config->policy)
+#define KERNEL_NAME dispatching
+#define KERNEL_ON_ARRIVAL POLICY->on_arrival
+#define KERNEL_PICK_NEXT POLICY->pick_next
+#define KERNEL_ON_TICK POLICY->on_tick
+#define KERNEL_HAS_TICK (POLICY->on_tick != NULL)
+#define KERNEL_SHOULD_PREEMPT POLICY->should_preempt
+#define KERNEL_HAS_PREEMPT (POLICY->should_preempt != NULL)
+#define KERNEL_ON_PREEMPT (POLICY->on_preempt ? POLICY->on_preempt : POLICY->on_arrival)
+#define KERNEL_ON_FINISH POLICY->on_finish
+#define KERNEL_HAS_FINISH (POLICY->on_finish != NULL)
+#define KERNEL_NEXT_DEADLINE POLICY->next_deadline
+#define KERNEL_HAS_DEADLINE (POLICY->next_deadline != NULL)
+#define KERNEL_STEAL POLICY->steal
+#define KERNEL_HAS_STEAL (POLICY->steal != NULL)
+#define KERNEL_ONE_CPU 0
+#include "sim_kernel.h"
+#undef POLICY
+
+// Sets up a run at time 0 with room for capacity arrivals
+static SimRun* open_run(ProcTable* procs, const SimConfig* config, SchedStats* stats,
+                        int capacity) {
+    // A slice spent entirely on dispatching would never let anything run
+    if (config->policy->uses_quantum &&
+        config->dispatch_cost + config->switch_cost >= config->quantum) {
+        fprintf(stderr, "Dispatch and switch costs (%d) must be less than the quantum (%d)\n",
+                config->dispatch_cost + config->switch_cost, config->quantum);
+        exit(1);
+    }
+    // Every deadline is computed from the clock with int arithmetic
+    if ((long long)config->dispatch_cost + config->switch_cost > SIM_MAX_TIME ||
+        config->aging_interval > SIM_MAX_TIME) {
+        fprintf(stderr, "Dispatch and switch costs and the aging interval must be at most %d\n",
+                SIM_MAX_TIME);
+        exit(1);
+    }
+    if (config->quantum > SIM_MAX_TIME >> (MLFQ_LEVELS - 1)) {
+        fprintf(stderr, "The quantum must be at most %d\n", SIM_MAX_TIME >> (MLFQ_LEVELS - 1));
+        exit(1);
+    }
+
+    SimRun* run = (SimRun*)sim_alloc(sizeof(SimRun));
+    memset(run, 0, sizeof(*run));
+    run->procs = procs;
+    run->config = config;
+    run->stats = stats;
+    run->kernel = config->policy->kernel != NULL && !config->dynamic ? config->policy->kernel
+                                                                    : &dispatching_kernel;
+    run->arrivals = (Arrival*)sim_alloc(capacity * sizeof(Arrival));
+    run->arrival_capacity = capacity;
+    if (procs->first_burst != NULL) {
+        run->burst_at = (int*)sim_alloc(procs->capacity * sizeof(int));
+        run->blocked = newpqueue(procs->capacity);
+    }
+
+    stats->total_time = 0;
+    stats->cpu_busy_time = 0;
+    stats->num_processes = 0;
+    stats->total_waiting_time = 0.0;
+    stats->total_response_time = 0.0;
+    stats->total_turnaround_time = 0.0;
+    stats->events = 0;
+    stats->num_cpus = config->cpus;
+    stats->migrations = 0;
+    stats->load_imbalance = 0.0;
+    stats->overhead_time = 0;
+    stats->dispatches = 0;
+    stats->switches = 0;
+    stats->blocks = 0;
+    hist_init(&stats->waiting);
+    hist_init(&stats->response);
+    hist_init(&stats->turnaround);
+    for (int cpu = 0; cpu < config->cpus; cpu++) {
+        run->state[cpu] = config->policy->create(procs, config, cpu,
+                                                 cpu > 0 ? run->state[0] : NULL);
+        run->running[cpu] = -1;
+        stats->cpu_busy[cpu] = 0;
+    }
+    return run;
+}
+
+// Starts a run with no arrivals queued
+SimRun* sim_open(ProcTable* procs, const SimConfig* config, SchedStats* stats) {
+    return open_run(procs, config, stats, 64);
+}
+
+// Queues a process to arrive at the current time, which becomes its arrival time
+void sim_arrive(SimRun* run, int id) {
+    if (run->next_arrival == run->num_arrivals) {
+        run->next_arrival = run->num_arrivals = 0;  // all admitted; start over
+    }
+    if (run->num_arrivals == run->arrival_capacity) {
+        run->arrival_capacity *= 2;
+        run->arrivals = (Arrival*)realloc(run->arrivals, run->arrival_capacity * sizeof(Arrival));
+        if (run->arrivals == NULL) {
+            fprintf(stderr, "Failed to allocate memory for simulation\n");
+            exit(1);
+        }
+    }
+    run->procs->arrival_time[id] = run->now;
+    run->arrivals[run->num_arrivals].arrival_time = run->now;
+    run->arrivals[run->num_arrivals++].index = id;
+}
+
+int sim_step(SimRun* run) {
+    return run->kernel->step(run);
+}
+
+void sim_advance(SimRun* run, int time) {
+    advance(run, time, run->config->cpus == 1);
+}
+
+// Fills in the totals that depend on the whole run and frees it
+void sim_close(SimRun* run) {
+    const SimConfig* config = run->config;
+    SchedStats* stats = run->stats;
+    int cpus = config->cpus;
+
+    stats->total_time = run->now;
+    stats->load_imbalance = 0.0;
+    if (stats->cpu_busy_time > 0) {
+        int most = 0;
+        for (int cpu = 0; cpu < cpus; cpu++) {
+            most = stats->cpu_busy[cpu] > most ? stats->cpu_busy[cpu] : most;
+        }
+        stats->load_imbalance = (double)most * cpus / stats->cpu_busy_time - 1.0;
+    }
+    for (int cpu = cpus - 1; cpu >= 0; cpu--) {
+        config->policy->destroy(run->state[cpu]);   // CPU 0's state is shared, so it goes last
+    }
+    free(run->arrivals);
+    free(run->burst_at);
+    pq_free(run->blocked);
+    free(run);
+}
+
+/* Runs a whole trace one event time at a time
+ * After each event time the clock jumps to the next arrival, completion
+ * or policy deadline, so idle gaps and long bursts cost nothing. The
+ * loop itself is the policy's kernel, so nothing in it goes through a
+ * function pointer unless config->dynamic asks for that.
+ */
+void sim_run(ProcTable* procs, const SimConfig* config, SchedStats* stats) {
+    int count = procs->count;
+    SimRun* run = open_run(procs, config, stats, count > 0 ? count : 1);
+    Arrival* arrivals = run->arrivals;
+    int every = config->snapshot_every > 0 ? config->snapshot_every : SNAPSHOT_EVERY;
+    long long next_snapshot = every;
+    unsigned long long trace = 0;
+
+    // Traces are usually in arrival order already; only sort when not
+    int sorted = 1;
+    for (int i = 0; i < count; i++) {
+        arrivals[i].arrival_time = procs->arrival_time[i];
+        arrivals[i].index = i;
+        sorted &= i == 0 || procs->arrival_time[i - 1] <= procs->arrival_time[i];
+    }
+    if (!sorted) {
+        qsort(arrivals, count, sizeof(Arrival), compare_arrivals);
+    }
+    run->num_arrivals = count;
+
+    // Fingerprint the trace before any priority ages
+    if (config->snapshot || config->resume) {
+        trace = trace_hash(procs);
+    }
+    if (config->resume) {
+        load_snapshot(run, trace);
+        next_snapshot = ((long long)run->now / every + 1) * every;
+    }
+
+    run->kernel->run(run, next_snapshot, trace, sorted);
+    sim_close(run);
+}
@@ -0,0 +1,272 @@
+/*
+ * sim_engine.h - discrete-event core shared by the scheduler simulators
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+
+#ifndef SIM_ENGINE_H_
+#define SIM_ENGINE_H_
+
+#include <stdio.h>
+#include <limits.h>
+#include "proc_table.h"
+#include "latency_hist.h"
+
+
+#define AGING_INTERVAL 8	// time a PP process waits before its priority goes up
+#define QUANTUM 4			// default RR time slice, and MLFQ top-level slice
+#define MLFQ_LEVELS 3		// MLFQ queues; level n gets a slice of QUANTUM << n
+#define MLFQ_BOOST 16		// MLFQ moves everything back to the top every 16 slices
+#define SIM_MAX_CPUS 256	// most CPUs a simulation can have
+#define SNAPSHOT_EVERY 1000000	// default simulated time between snapshots
+#define SIM_MAX_TIME (INT_MAX / 2)	// latest time a run may reach; the rest of int is
+								// headroom for wakes and deadlines computed from it
+
+/* Statistics tracking structure
+ * Maintains running totals of various performance metrics
+ * Used to calculate final averages and CPU utilization, with a histogram
+ * per time for percentiles
+ */
+typedef struct {
+	int total_time;					// Total simulation time
+	long long cpu_busy_time;		// Time CPU was busy, overhead included
+	int num_processes;				// Number of completed processes
+	double total_waiting_time;		// Sum of all process waiting times
+	double total_response_time;		// Sum of all process response times
+	double total_turnaround_time;	// Sum of all process turnaround times
+	long long events;				// event times the clock stopped at
+	int num_cpus;					// CPUs simulated
+	int migrations;					// processes moved to another CPU's queue by stealing
+	int cpu_busy[SIM_MAX_CPUS];		// busy time of each CPU; cpu_busy_time is their sum
+	double load_imbalance;			// busiest CPU's busy time over the mean, minus 1
+	long long overhead_time;		// part of cpu_busy_time spent dispatching and switching
+	long long dispatches;			// times a CPU was given a process
+	long long switches;				// dispatches that replaced another process on the CPU
+	long long blocks;				// times a process left the CPU to wait on I/O
+	LatencyHist waiting;			// distribution of each process's waiting time
+	LatencyHist response;			// ... response time
+	LatencyHist turnaround;			// ... turnaround time
+} SchedStats;
+
+/* Event codes passed to the event callback */
+enum {
+	EV_ARRIVE,		// process joined the ready queue
+	EV_DISPATCH,	// process was given the CPU
+	EV_PREEMPT,		// running process was put back in the ready queue
+	EV_RUN,			// process held the CPU for [time, end)
+	EV_IDLE,		// CPU had nothing to run for [time, end); pid is 0
+	EV_AGE,			// waiting process had its priority raised
+	EV_FINISH,		// process completed
+	EV_SWITCH,		// CPU spent [time, end) dispatching pid, before it runs
+	EV_BLOCK,		// process finished a CPU burst and is waiting on I/O
+	EV_WAKE			// process is done with I/O and ready to run again
+};
+
+/*
+ * called once per event; time == end except for EV_RUN, EV_IDLE and
+ * EV_SWITCH, which cover every tick from time up to but not including end; cpu is
+ * the CPU the event happened on (always 0 with one CPU)
+ */
+typedef void (*sim_event_fn)(void* ctx, int code, int time, int end, int pid, int cpu);
+
+/* Where an arriving process is queued when there is more than one CPU */
+typedef enum {
+	PLACE_ROUND_ROBIN,	// each arrival goes to the next CPU in turn
+	PLACE_LEAST_LOADED	// to the CPU with the fewest running and waiting processes
+} SimPlacement;
+
+typedef struct SimConfig SimConfig;
+typedef struct SimKernel SimKernel;
+
+/* Scheduling policy
+ * The engine owns the clock, arrivals, the running process and the
+ * statistics; a policy owns its ready queue(s) and decides who runs.
+ * With several CPUs each CPU gets its own policy state. Processes are
+ * passed as indexes into the process table. Hooks marked optional may
+ * be NULL.
+ */
+typedef struct {
+	const char* name;		// name used on the command line, e.g. "RR"
+	int uses_priority;		// reads the priority column of the trace
+	int uses_quantum;		// reads config->quantum
+	int uses_aging;			// reads config->aging_interval
+
+	// allocates the policy's state for one CPU; share is CPU 0's state
+	// (NULL for CPU 0 itself), whose per-process arrays the others use
+	void* (*create)(ProcTable* procs, const SimConfig* config, int cpu, void* share);
+	void (*destroy)(void* state);
+
+	// a process arrived and is ready to run
+	void (*on_arrival)(void* state, int id, int now);
+
+	// removes and returns the process to run next; only called when the
+	// CPU has a process waiting
+	int (*pick_next)(void* state, int now);
+
+	// optional: the clock reached now; do any time-based work (aging,
+	// slice bookkeeping). running is the process on the CPU or -1. Not
+	// called for a CPU with nothing running or waiting
+	void (*on_tick)(void* state, int running, int now);
+
+	// optional: should running give up the CPU to a ready process now?
+	// NULL for non-preemptive policies
+	int (*should_preempt)(void* state, int running, int now);
+
+	// optional: running was preempted and is ready again; defaults to on_arrival
+	void (*on_preempt)(void* state, int id, int now);
+
+	// optional: a process used up its last burst; one that blocks on I/O
+	// is not finished, and comes back through on_arrival when it wakes
+	void (*on_finish)(void* state, int id, int now);
+
+	// optional: next time the policy needs on_tick, or INT_MAX if never;
+	// not called for a CPU with nothing running or waiting
+	int (*next_deadline)(void* state, int running, int now);
+
+	// optional: removes a waiting process so an idle CPU can take it;
+	// only called when the CPU has one. NULL if work cannot be stolen
+	int (*steal)(void* state, int now);
+
+	// writes whatever the state has changed since create to a snapshot;
+	// processes from ids on have not arrived yet. Returns 0, or -1 if a
+	// write failed
+	int (*save)(void* state, FILE* out, int ids);
+
+	// reads back what save wrote, into a state fresh from create;
+	// returns 0, or -1 if the snapshot does not fit the state
+	int (*load)(void* state, FILE* in, int ids);
+
+	// optional: the engine loop compiled with these hooks built in (see
+	// sim_kernel.h); NULL runs the policy through the hooks above
+	const SimKernel* kernel;
+} SimPolicy;
+
+/* Settings for one simulation run */
+struct SimConfig {
+	const SimPolicy* policy;
+	int aging_interval;		// PP aging period, normally AGING_INTERVAL
+	int quantum;			// RR and MLFQ time slice, normally QUANTUM
+	int finish_last;		// report a finish after arrivals and aging at the same time
+	int age_by_index;		// report same-time aging in trace order, not queue order
+	int cpus;				// CPUs to simulate, 1 to SIM_MAX_CPUS
+	SimPlacement placement;	// where arrivals are queued when cpus > 1
+	int steal;				// idle CPUs take work waiting on other CPUs
+	sim_event_fn on_event;	// event callback, may be NULL
+	void* ctx;				// passed back to on_event and on_snapshot
+	const char* snapshot;	// file to keep the latest snapshot in, NULL for none
+	int snapshot_every;		// simulated time between snapshots
+	const char* resume;		// snapshot to continue from instead of time 0, or NULL
+	// optional: called just before each snapshot; writes out anything
+	// buffered and returns the bytes of output so far, which the
+	// snapshot records
+	long long (*on_snapshot)(void* ctx);
+	int dynamic;			// call the policy's hooks through pointers even if it
+							// has a compiled kernel, to compare the two
+	int dispatch_cost;		// CPU time each dispatch takes before the process runs
+	int switch_cost;		// more on top when it replaces another process; both
+							// count as busy time, and a time slice includes them
+};
+
+/* A simulation in progress, for drivers that feed arrivals as they come */
+typedef struct SimRun SimRun;
+
+/* What a snapshot says about where it was taken */
+typedef struct {
+	char policy[8];			// policy name
+	int cpus;				// CPUs simulated
+	int count;				// processes in the trace
+	int time;				// clock when it was taken
+	long long output;		// bytes of output the run had written by then
+} SimSnapshotInfo;
+
+
+/*
+ * looks up a policy by name
+ * const char* name: FCFS, PP, RR, SJF, SRTF or MLFQ
+ * returns: the policy, or NULL if there is none by that name
+ */
+const SimPolicy* sim_find_policy (const char* name);
+
+/*
+ * reports an event to the configured callback, if there is one; for
+ * policies that have something to report, such as aging
+ * returns: nothing
+ */
+void sim_emit (const SimConfig* config, int code, int time, int end, int pid, int cpu);
+
+/*
+ * reads where a snapshot was taken without loading it
+ * const char* path: a snapshot written by sim_run
+ * SimSnapshotInfo* info: receives its header
+ * returns: 0 on success, -1 if path cannot be read or is not a snapshot
+ */
+int sim_snapshot_info (const char* path, SimSnapshotInfo* info);
+
+/*
+ * simulates a trace from time 0 until every process has finished
+ * ProcTable* procs: the processes, in trace order; updated in place
+ * const SimConfig* config: policy and event reporting settings
+ * SchedStats* stats: receives the totals for the run
+ * returns: nothing; the clock jumps from event to event, so run time
+ * 			depends on the number of events, not on simulated time.
+ * 			With config->snapshot set, the whole run state is written
+ * 			there every snapshot_every ticks, between events; with
+ * 			config->resume set, the run starts from such a snapshot and
+ * 			reports exactly what the original run reported after it.
+ * 			The policy, CPU count and trace must be the ones it was
+ * 			taken with; quantum, aging, placement and stealing may
+ * 			differ, to try alternatives from the same point. A bad
+ * 			snapshot stops the program with a message
+ */
+void sim_run (ProcTable* procs, const SimConfig* config, SchedStats* stats);
+
+/*
+ * starts a run at time 0 with nothing queued to arrive, for a driver
+ * that adds arrivals itself; snapshot and resume settings are ignored
+ * ProcTable* procs: a table with a row for every id that will be used;
+ * 			a row may be reused for a new process once its last one
+ * 			has finished, after resetting its columns
+ * returns: the run, to be driven with sim_arrive, sim_step and
+ * 			sim_advance and ended with sim_close
+ */
+SimRun* sim_open (ProcTable* procs, const SimConfig* config, SchedStats* stats);
+
+/*
+ * queues a process to arrive at the run's current time, which is stored
+ * as its arrival time; it is admitted by the next sim_step
+ * returns: nothing
+ */
+void sim_arrive (SimRun* run, int id);
+
+/*
+ * handles the current time: retires finished processes, admits
+ * arrivals, and dispatches, preempts and steals; may be called again
+ * at the same time after more arrivals
+ * returns: the next time anything can change without new arrivals, or
+ * 			INT_MAX if nothing can
+ */
+int sim_step (SimRun* run);
+
+/*
+ * moves the clock forward, reporting the time in between as run and
+ * idle intervals
+ * int time: the new time; at least the current time and at most what
+ * 			the last sim_step returned
+ * returns: nothing
+ */
+void sim_advance (SimRun* run, int time);
+
+/*
+ * ends a run: fills in its total time and load imbalance and frees it
+ * returns: nothing
+ */
+void sim_close (SimRun* run);
+
+
+#endif /* SIM_ENGINE_H_ */
@@ -0,0 +1,289 @@
+/*
+ * sim_internal.h - engine internals shared by sim_engine.c and the compiled kernels
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ *
+ * Only sim_engine.c and the policy files that instantiate sim_kernel.h
+ * include this; the simulators see SimRun as an opaque handle.
+ */
+
+
+#ifndef SIM_INTERNAL_H_
+#define SIM_INTERNAL_H_
+
+#include <stdlib.h>
+#include <limits.h>
+#include "sim_engine.h"
+#include "my_pqueue.h"
+
+
+// Arrival time paired with trace position, sorted to get arrival order
+typedef struct {
+    int arrival_time;
+    int index;
+} Arrival;
+
+#define CPU_WORDS ((SIM_MAX_CPUS + 63) / 64)
+
+// One bit per CPU, so only CPUs with work are visited each event
+typedef struct {
+    unsigned long long bits[CPU_WORDS];
+} CpuSet;
+
+/* The engine loop compiled for one policy (see sim_kernel.h)
+ * step handles one event time and returns the next, as sim_step does;
+ * run drives a whole trace to the end, snapshotting on the way. Both
+ * take a path of their own when there is only one CPU
+ */
+struct SimKernel {
+    int (*step)(SimRun* run);
+    void (*run)(SimRun* run, long long next_snapshot, unsigned long long trace, int sorted);
+};
+
+/* A run in progress
+ * sim_run drives one through a whole trace; an online driver adds
+ * arrivals as they happen and moves the clock itself
+ */
+struct SimRun {
+    ProcTable* procs;
+    const SimConfig* config;
+    SchedStats* stats;
+    const SimKernel* kernel;        // the policy's own, or the dispatching one
+    void* state[SIM_MAX_CPUS];
+    int running[SIM_MAX_CPUS];
+    int queued[SIM_MAX_CPUS];       // processes waiting in each CPU's policy
+    int waiting;                    // sum of queued
+    int num_busy;                   // CPUs running something
+    CpuSet active;                  // CPUs running or holding a process
+    CpuSet busy;                    // CPUs running a process
+    Arrival* arrivals;              // arrival order; those from next_arrival on are to come
+    int num_arrivals;
+    int arrival_capacity;
+    int next_arrival;
+    int next_cpu;                   // next CPU for round robin placement
+    int completed;                  // processes finished
+    int now;
+    int overhead[SIM_MAX_CPUS];     // dispatch time each CPU still owes before its process runs
+    int* burst_at;                  // with bursts: each process's CPU burst, as a list index
+    pqueue blocked;                 // with bursts: processes waiting on I/O, soonest wake on top
+};
+
+
+/*
+ * writes the whole run state to config->snapshot, between event times
+ * unsigned long long trace: fingerprint of the trace, checked on resume
+ * int sorted: whether the trace was in arrival order
+ * returns: nothing; a failed write stops the program with a message
+ */
+void sim_save_snapshot (const SimRun* run, unsigned long long trace, int sorted);
+
+
+// Records a finished process in the statistics; time blocked on I/O is not waiting
+static inline void complete(ProcTable* procs, int id, SchedStats* stats, int now) {
+    int waiting = now - procs->arrival_time[id] - procs->cpu_time[id];
+    if (procs->io_time != NULL) {
+        waiting -= procs->io_time[id];
+    }
+    int response = procs->start_time[id] - procs->arrival_time[id];
+    int turnaround = now - procs->arrival_time[id];
+    procs->completion_time[id] = now;
+    stats->total_waiting_time += waiting;
+    stats->total_response_time += response;
+    stats->total_turnaround_time += turnaround;
+    stats->num_processes++;
+    hist_record(&stats->waiting, waiting);
+    hist_record(&stats->response, response);
+    hist_record(&stats->turnaround, turnaround);
+}
+
+/* Gives a process the CPU
+ * The CPU owes the dispatch cost, and the switch cost too when it was
+ * running another process up to now, before the process makes progress;
+ * its response time runs until then.
+ */
+static inline void dispatch(SimRun* run, int id, int cpu, int switched) {
+    const SimConfig* config = run->config;
+    ProcTable* procs = run->procs;
+    int cost = config->dispatch_cost + (switched ? config->switch_cost : 0);
+    run->overhead[cpu] = cost;
+    run->stats->dispatches++;
+    run->stats->switches += switched;
+    if (procs->start_time[id] == -1) {
+        procs->start_time[id] = run->now + cost;
+    }
+    sim_emit(config, EV_DISPATCH, run->now, run->now, procs->pid[id], cpu);
+}
+
+/* Moves a process that used up a CPU burst on to its I/O, if it has any
+ * left; it is queued to wake when the I/O is done, with its next CPU
+ * burst ready
+ * returns: 1 if it blocked, 0 if that was its last burst
+ */
+static inline int block(SimRun* run, int id, int now) {
+    ProcTable* procs = run->procs;
+    if (run->blocked == NULL || procs->first_burst[id] == -1) {
+        return 0;
+    }
+    const int* list = procs->bursts + procs->first_burst[id];
+    int at = run->burst_at[id];
+    if (at + 1 >= list[0]) {
+        return 0;
+    }
+    // list[0] is the count, so burst at is list[at + 1]; the loader keeps
+    // each process's I/O under SIM_MAX_TIME, so the wake time fits an int
+    long long wake = (long long)now + list[at + 2];
+    pq_push(run->blocked, id, -(int)wake);
+    procs->remaining_time[id] = list[at + 3];
+    run->burst_at[id] = at + 2;
+    run->stats->blocks++;
+    return 1;
+}
+
+// When the first blocked process wakes, or INT_MAX if none is blocked
+static inline int next_wake(const SimRun* run) {
+    if (run->blocked == NULL || pq_isempty(run->blocked)) {
+        return INT_MAX;
+    }
+    return -run->blocked->key[pq_peek(run->blocked)];
+}
+
+/* Picks the CPU an arriving process is queued on
+ * Load is the running process plus the ready queue; ties go to the
+ * lowest numbered CPU
+ */
+static inline int place(const SimConfig* config, const int* queued, const int* running,
+                        int* next_cpu) {
+    if (config->cpus == 1) {
+        return 0;
+    }
+    if (config->placement == PLACE_ROUND_ROBIN) {
+        int cpu = *next_cpu;
+        *next_cpu = (cpu + 1) % config->cpus;
+        return cpu;
+    }
+    int best = 0;
+    int best_load = INT_MAX;
+    for (int cpu = 0; cpu < config->cpus; cpu++) {
+        int load = queued[cpu] + (running[cpu] != -1);
+        if (load < best_load) {
+            best = cpu;
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+// Finds the CPU with the most waiting processes, or -1 if none are waiting
+static inline int busiest(const SimConfig* config, const int* queued) {
+    int victim = -1;
+    int most = 0;
+    for (int cpu = 0; cpu < config->cpus; cpu++) {
+        if (queued[cpu] > most) {
+            victim = cpu;
+            most = queued[cpu];
+        }
+    }
+    return victim;
+}
+
+// Whether a CPU is in a set
+static inline int cpuset_has(const CpuSet* set, int cpu) {
+    return (set->bits[cpu / 64] >> (cpu % 64)) & 1;
+}
+
+// Adds or removes a CPU
+static inline void cpuset_put(CpuSet* set, int cpu, int member) {
+    unsigned long long bit = 1ULL << (cpu % 64);
+    if (member) {
+        set->bits[cpu / 64] |= bit;
+    } else {
+        set->bits[cpu / 64] &= ~bit;
+    }
+}
+
+/* Walks the CPUs of a set in increasing order
+ * Each word is copied when reached, so the body may change the set; a
+ * change to a CPU already passed or in the current word is not seen.
+ */
+#define FOR_EACH_CPU(set, cpu) FOR_EACH_CPU_IN(set, cpu, CPU_WORDS)
+
+// The same over only the first words of the set, for runs known to have fewer CPUs
+#define FOR_EACH_CPU_IN(set, cpu, words) \
+    for (int w_ = 0; w_ < (words); w_++) \
+        for (unsigned long long b_ = (set).bits[w_]; \
+             b_ != 0 && ((cpu) = w_ * 64 + __builtin_ctzll(b_), 1); b_ &= b_ - 1)
+
+// Files a CPU under active (running or queued) and busy (running)
+static inline void track(CpuSet* active, CpuSet* busy, int cpu, int running, int queued) {
+    cpuset_put(active, cpu, running != -1 || queued > 0);
+    cpuset_put(busy, cpu, running != -1);
+}
+
+// The CPUs below cpus that are not in set
+static inline CpuSet complement(const CpuSet* set, int cpus) {
+    CpuSet out;
+    for (int w = 0; w < CPU_WORDS; w++) {
+        int low = w * 64;
+        unsigned long long valid = cpus >= low + 64 ? ~0ULL
+                                 : cpus > low ? (1ULL << (cpus - low)) - 1 : 0;
+        out.bits[w] = ~set->bits[w] & valid;
+    }
+    return out;
+}
+
+/* Moves the clock up to time, reporting the time in between as one run
+ * or idle interval per CPU, with any dispatch overhead still owed first
+ * one_cpu: the run has a single CPU; a constant lets the compiler drop
+ * 			the walk over the CPU sets
+ */
+static inline void advance(SimRun* run, int time, int one_cpu) {
+    const SimConfig* config = run->config;
+    ProcTable* procs = run->procs;
+    SchedStats* stats = run->stats;
+    int now = run->now;
+    int elapsed = time - now;
+    int cpu;
+    if (time > SIM_MAX_TIME) {
+        // Only dispatch costs or a long-lived service get here; traces are checked on load
+        fprintf(stderr, "Simulated time passed %d\n", SIM_MAX_TIME);
+        exit(1);
+    }
+
+    // With a log, idle CPUs report too, so visit them all in order
+    CpuSet report = run->busy;
+    if (elapsed > 0 && config->on_event) {
+        CpuSet none = { { 0 } };
+        report = complement(&none, config->cpus);
+    }
+    FOR_EACH_CPU_IN(report, cpu, one_cpu ? 1 : CPU_WORDS) {
+        int id = run->running[cpu];
+        if (id != -1) {
+            int spent = 0;
+            if (run->overhead[cpu] > 0) {
+                spent = run->overhead[cpu] < elapsed ? run->overhead[cpu] : elapsed;
+                run->overhead[cpu] -= spent;
+                stats->overhead_time += spent;
+                if (spent > 0) {
+                    sim_emit(config, EV_SWITCH, now, now + spent, procs->pid[id], cpu);
+                }
+            }
+            if (spent < elapsed || elapsed == 0) {
+                sim_emit(config, EV_RUN, now + spent, time, procs->pid[id], cpu);
+            }
+            procs->remaining_time[id] -= elapsed - spent;
+            stats->cpu_busy[cpu] += elapsed;
+            stats->cpu_busy_time += elapsed;
+        } else {
+            sim_emit(config, EV_IDLE, now, time, 0, cpu);
+        }
+    }
+    run->now = time;
+}
+
+
+#endif /* SIM_INTERNAL_H_ */
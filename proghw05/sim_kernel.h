@@ -0,0 +1,304 @@
+/*
+ * sim_kernel.h - the engine loop, compiled once per policy
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ *
+ * Not a normal header: each include stamps out one copy of the event
+ * loop with a policy's hooks called directly, so the compiler can inline
+ * them and drop the code for hooks the policy does not have. Before
+ * including it, define
+ *     KERNEL_NAME               prefix of what it defines: NAME_step,
+ *                               NAME_run and the SimKernel NAME_kernel
+ *     KERNEL_ON_ARRIVAL         the SimPolicy hooks of the same names,
+ *     KERNEL_PICK_NEXT          as functions or anything callable
+ * and any of the optional hooks the policy has
+ *     KERNEL_ON_TICK, KERNEL_SHOULD_PREEMPT, KERNEL_ON_PREEMPT,
+ *     KERNEL_ON_FINISH, KERNEL_NEXT_DEADLINE, KERNEL_STEAL
+ * Each optional hook left undefined is compiled out. A hook that is only
+ * known at run time can be given with KERNEL_HAS_<hook> set to the test
+ * for it (KERNEL_HAS_TICK, _PREEMPT, _FINISH, _DEADLINE, _STEAL); these
+ * may use the run being handled, called run. Unless KERNEL_ONE_CPU is
+ * defined as 0, the loop is compiled a second time for runs with one
+ * CPU, without CPU set walks, placement or stealing. Every KERNEL_ macro
+ * is undefined again at the end.
+ */
+
+#include "sim_internal.h"
+
+#if !defined(KERNEL_NAME) || !defined(KERNEL_ON_ARRIVAL) || !defined(KERNEL_PICK_NEXT)
+#error "define KERNEL_NAME, KERNEL_ON_ARRIVAL and KERNEL_PICK_NEXT before including sim_kernel.h"
+#endif
+
+#ifndef KERNEL_ON_TICK
+#define KERNEL_ON_TICK(state, running, now) ((void)0)
+#define KERNEL_HAS_TICK 0
+#elif !defined(KERNEL_HAS_TICK)
+#define KERNEL_HAS_TICK 1
+#endif
+
+#ifndef KERNEL_SHOULD_PREEMPT
+#define KERNEL_SHOULD_PREEMPT(state, running, now) 0
+#define KERNEL_HAS_PREEMPT 0
+#elif !defined(KERNEL_HAS_PREEMPT)
+#define KERNEL_HAS_PREEMPT 1
+#endif
+
+#ifndef KERNEL_ON_PREEMPT
+#define KERNEL_ON_PREEMPT KERNEL_ON_ARRIVAL
+#endif
+
+#ifndef KERNEL_ON_FINISH
+#define KERNEL_ON_FINISH(state, id, now) ((void)0)
+#define KERNEL_HAS_FINISH 0
+#elif !defined(KERNEL_HAS_FINISH)
+#define KERNEL_HAS_FINISH 1
+#endif
+
+#ifndef KERNEL_NEXT_DEADLINE
+#define KERNEL_NEXT_DEADLINE(state, running, now) INT_MAX
+#define KERNEL_HAS_DEADLINE 0
+#elif !defined(KERNEL_HAS_DEADLINE)
+#define KERNEL_HAS_DEADLINE 1
+#endif
+
+#ifndef KERNEL_STEAL
+#define KERNEL_STEAL(state, now) (-1)
+#define KERNEL_HAS_STEAL 0
+#elif !defined(KERNEL_HAS_STEAL)
+#define KERNEL_HAS_STEAL 1
+#endif
+
+#ifndef KERNEL_ONE_CPU
+#define KERNEL_ONE_CPU 1
+#endif
+
+// CPU set words a body walks: one when it is compiled for a single CPU
+#define KERNEL_WORDS (one_cpu ? 1 : CPU_WORDS)
+
+#define KERNEL_JOIN_(prefix, name) prefix##_##name
+#define KERNEL_JOIN(prefix, name) KERNEL_JOIN_(prefix, name)
+
+/* Handles one event time
+ * Finish or block running processes that are done with their burst,
+ * queue wakeups and arrivals on a CPU, let each CPU's policy do its
+ * time-based work, then dispatch or preempt on each CPU and let idle
+ * CPUs steal waiting work. The engine counts each CPU's waiting
+ * processes itself, so CPUs with nothing to do cost no policy calls.
+ */
+static inline __attribute__((always_inline))
+int KERNEL_JOIN(KERNEL_NAME, event)(SimRun* run, const int one_cpu) {
+    const SimConfig* config = run->config;
+    ProcTable* procs = run->procs;
+    SchedStats* stats = run->stats;
+    void** state = run->state;
+    int* running = run->running;
+    int* queued = run->queued;
+    int finished[SIM_MAX_CPUS];     // processes done at this event time
+    int finished_on[SIM_MAX_CPUS];  // and the CPUs they ran on
+    int num_finished = 0;
+    int now = run->now;
+    int cpus = one_cpu ? 1 : config->cpus;
+    CpuSet was_busy = run->busy;    // a dispatch onto one of these is a switch
+    int cpu;
+
+    stats->events++;
+
+    // Retire running processes once their bursts are used up, or send
+    // them off to their next I/O
+    FOR_EACH_CPU_IN(run->busy, cpu, KERNEL_WORDS) {
+        int id = running[cpu];
+        if (procs->remaining_time[id] <= 0 && run->overhead[cpu] == 0) {
+            running[cpu] = -1;
+            run->num_busy--;
+            track(&run->active, &run->busy, cpu, -1, queued[cpu]);
+            if (block(run, id, now)) {
+                sim_emit(config, EV_BLOCK, now, now, procs->pid[id], cpu);
+                continue;
+            }
+            finished[num_finished] = id;
+            finished_on[num_finished++] = cpu;
+            complete(procs, id, stats, now);
+            run->completed++;
+            if (KERNEL_HAS_FINISH) {
+                KERNEL_ON_FINISH(state[cpu], id, now);
+            }
+            if (!config->finish_last) {
+                sim_emit(config, EV_FINISH, now, now, procs->pid[id], cpu);
+            }
+        }
+    }
+
+    // Processes done with their I/O are ready again, ahead of new arrivals
+    while (next_wake(run) <= now) {
+        int id = pq_pop(run->blocked);
+        cpu = one_cpu ? 0 : place(config, queued, running, &run->next_cpu);
+        KERNEL_ON_ARRIVAL(state[cpu], id, now);
+        queued[cpu]++;
+        run->waiting++;
+        cpuset_put(&run->active, cpu, 1);
+        sim_emit(config, EV_WAKE, now, now, procs->pid[id], cpu);
+    }
+
+    // Admit everything that has arrived by now
+    while (run->next_arrival < run->num_arrivals &&
+           run->arrivals[run->next_arrival].arrival_time <= now) {
+        int id = run->arrivals[run->next_arrival++].index;
+        cpu = one_cpu ? 0 : place(config, queued, running, &run->next_cpu);
+        if (run->burst_at != NULL) {
+            run->burst_at[id] = 0;
+        }
+        KERNEL_ON_ARRIVAL(state[cpu], id, now);
+        queued[cpu]++;
+        run->waiting++;
+        cpuset_put(&run->active, cpu, 1);
+        sim_emit(config, EV_ARRIVE, now, now, procs->pid[id], cpu);
+    }
+
+    if (KERNEL_HAS_TICK) {
+        FOR_EACH_CPU_IN(run->active, cpu, KERNEL_WORDS) {
+            KERNEL_ON_TICK(state[cpu], running[cpu], now);
+        }
+    }
+
+    for (int i = 0; i < num_finished && config->finish_last; i++) {
+        sim_emit(config, EV_FINISH, now, now, procs->pid[finished[i]], finished_on[i]);
+    }
+
+    // Dispatch onto idle CPUs, or preempt if the policy says so
+    FOR_EACH_CPU_IN(run->active, cpu, KERNEL_WORDS) {
+        void* cpu_state = state[cpu];
+        if (queued[cpu] == 0) {
+            continue;
+        }
+        if (running[cpu] == -1) {
+            running[cpu] = KERNEL_PICK_NEXT(cpu_state, now);
+            queued[cpu]--;
+            run->waiting--;
+            run->num_busy++;
+            cpuset_put(&run->busy, cpu, 1);
+            dispatch(run, running[cpu], cpu, cpuset_has(&was_busy, cpu));
+        } else if (KERNEL_HAS_PREEMPT && KERNEL_SHOULD_PREEMPT(cpu_state, running[cpu], now)) {
+            int next = KERNEL_PICK_NEXT(cpu_state, now);
+            int id = running[cpu];
+            procs->flags[id] |= PROC_PREEMPTED;
+            sim_emit(config, EV_PREEMPT, now, now, procs->pid[id], cpu);
+            KERNEL_ON_PREEMPT(cpu_state, id, now);
+            running[cpu] = next;
+            dispatch(run, next, cpu, 1);
+        }
+    }
+
+    // CPUs left idle take a process waiting on the busiest CPU; one CPU
+    // is never idle with work waiting
+    if (KERNEL_HAS_STEAL && !one_cpu && run->waiting > 0 && run->num_busy < cpus &&
+        config->steal) {
+        CpuSet idle = complement(&run->busy, cpus);
+        FOR_EACH_CPU(idle, cpu) {
+            if (run->waiting == 0) {
+                continue;
+            }
+            int victim = busiest(config, queued);
+            int id = KERNEL_STEAL(state[victim], now);
+            queued[victim]--;
+            run->waiting--;
+            track(&run->active, &run->busy, victim, running[victim], queued[victim]);
+            stats->migrations++;
+            KERNEL_ON_ARRIVAL(state[cpu], id, now);
+            running[cpu] = KERNEL_PICK_NEXT(state[cpu], now);
+            run->num_busy++;
+            track(&run->active, &run->busy, cpu, running[cpu], queued[cpu]);
+            dispatch(run, running[cpu], cpu, cpuset_has(&was_busy, cpu));
+        }
+    }
+
+    // The next time anything can change
+    int next = next_wake(run);
+    if (run->next_arrival < run->num_arrivals &&
+        run->arrivals[run->next_arrival].arrival_time < next) {
+        next = run->arrivals[run->next_arrival].arrival_time;
+    }
+    FOR_EACH_CPU_IN(run->active, cpu, KERNEL_WORDS) {
+        int id = running[cpu];
+        long long finish = id != -1 ? (long long)now + run->overhead[cpu] + procs->remaining_time[id]
+                                    : LLONG_MAX;
+        if (finish < next) {
+            next = (int)finish;
+        }
+        if (KERNEL_HAS_DEADLINE) {
+            int deadline = KERNEL_NEXT_DEADLINE(state[cpu], id, now);
+            if (deadline < next) {
+                next = deadline;
+            }
+        }
+    }
+    return next;
+}
+
+/* Runs the queued arrivals to the end, one event time at a time
+ * Snapshots are taken before an event time is handled, when everything
+ * before it has been reported and nothing at it has.
+ */
+static inline __attribute__((always_inline))
+void KERNEL_JOIN(KERNEL_NAME, loop)(SimRun* run, long long next_snapshot,
+                                    unsigned long long trace, int sorted, const int one_cpu) {
+    const SimConfig* config = run->config;
+    int count = run->procs->count;
+    int every = config->snapshot_every > 0 ? config->snapshot_every : SNAPSHOT_EVERY;
+
+    while (run->completed < count) {
+        if (config->snapshot && run->now >= next_snapshot) {
+            sim_save_snapshot(run, trace, sorted);
+            next_snapshot = ((long long)run->now / every + 1) * every;
+        }
+        int next = KERNEL_JOIN(KERNEL_NAME, event)(run, one_cpu);
+        if (next == INT_MAX) {
+            break;  // nothing left that could ever run
+        }
+        advance(run, next, one_cpu);
+    }
+}
+
+// The entry points, each with the body compiled twice when KERNEL_ONE_CPU is set
+static int KERNEL_JOIN(KERNEL_NAME, step)(SimRun* run) {
+    if (KERNEL_ONE_CPU && run->config->cpus == 1) {
+        return KERNEL_JOIN(KERNEL_NAME, event)(run, 1);
+    }
+    return KERNEL_JOIN(KERNEL_NAME, event)(run, 0);
+}
+
+static void KERNEL_JOIN(KERNEL_NAME, run)(SimRun* run, long long next_snapshot,
+                                          unsigned long long trace, int sorted) {
+    if (KERNEL_ONE_CPU && run->config->cpus == 1) {
+        KERNEL_JOIN(KERNEL_NAME, loop)(run, next_snapshot, trace, sorted, 1);
+    } else {
+        KERNEL_JOIN(KERNEL_NAME, loop)(run, next_snapshot, trace, sorted, 0);
+    }
+}
+
+static const SimKernel KERNEL_JOIN(KERNEL_NAME, kernel) = {
+    KERNEL_JOIN(KERNEL_NAME, step), KERNEL_JOIN(KERNEL_NAME, run)
+};
+
+#undef KERNEL_NAME
+#undef KERNEL_ON_ARRIVAL
+#undef KERNEL_PICK_NEXT
+#undef KERNEL_ON_TICK
+#undef KERNEL_HAS_TICK
+#undef KERNEL_SHOULD_PREEMPT
+#undef KERNEL_HAS_PREEMPT
+#undef KERNEL_ON_PREEMPT
+#undef KERNEL_ON_FINISH
+#undef KERNEL_HAS_FINISH
+#undef KERNEL_NEXT_DEADLINE
+#undef KERNEL_HAS_DEADLINE
+#undef KERNEL_STEAL
+#undef KERNEL_HAS_STEAL
+#undef KERNEL_ONE_CPU
+#undef KERNEL_WORDS
+#undef KERNEL_JOIN_
+#undef KERNEL_JOIN
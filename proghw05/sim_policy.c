@@ -0,0 +1,481 @@
+/*
+ * sim_policy.c - Scheduling policies plugged into the simulation engine
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "my_pqueue.h"
+#include "sim_engine.h"
+#include "sim_internal.h"
+
+/* State shared by every policy; each one uses only the parts it needs
+ * Every ready queue is an indexed heap, so equal keys come out in the
+ * order they went in (the process that waited longest wins). Each CPU
+ * has its own state; the per-process arrays (queue positions, scratch)
+ * belong to CPU 0's state and are shared by the rest.
+ */
+typedef struct {
+    ProcTable* procs;
+    const SimConfig* config;
+    int cpu;                // CPU this state schedules
+    int owner;              // owns scratch and the queues' per-process arrays
+    pqueue ready;           // ready processes
+    pqueue aging;           // PP: ready processes by aging clock, earliest on top
+    int* scratch;           // PP: processes aged this tick; MLFQ: queue level of each process
+    int slice_start;        // RR, MLFQ: when the running process got the CPU
+    int slice_used;         // MLFQ: the running process's slice ran out just now
+    long long next_boost;   // MLFQ: when everything next moves back to the top
+} PolicyState;
+
+// Allocates memory or exits
+static void* policy_alloc(size_t size) {
+    void* mem = calloc(1, size > 0 ? size : 1);
+    if (mem == NULL) {
+        fprintf(stderr, "Failed to allocate memory for scheduling policy\n");
+        exit(1);
+    }
+    return mem;
+}
+
+// Makes a queue, sharing per-process arrays with CPU 0's queue if given
+static pqueue new_queue(ProcTable* procs, pqueue share) {
+    return share ? newpqueue_shared(share) : newpqueue(procs->count);
+}
+
+// Creates the state common to all policies
+static void* create_state(ProcTable* procs, const SimConfig* config, int cpu, void* share) {
+    PolicyState* s = (PolicyState*)policy_alloc(sizeof(PolicyState));
+    PolicyState* first = (PolicyState*)share;
+    s->procs = procs;
+    s->config = config;
+    s->cpu = cpu;
+    s->owner = first == NULL;
+    s->ready = new_queue(procs, first ? first->ready : NULL);
+    s->aging = NULL;
+    s->scratch = NULL;
+    return s;
+}
+
+// Gives a state the per-process scratch array, shared between CPUs
+static void create_scratch(PolicyState* s, void* share) {
+    if (share) {
+        s->scratch = ((PolicyState*)share)->scratch;
+    } else {
+        s->scratch = (int*)policy_alloc(s->procs->count * sizeof(int));
+    }
+}
+
+// Releases policy state
+static void destroy_state(void* state) {
+    PolicyState* s = (PolicyState*)state;
+    if (s->aging) {
+        pq_free(s->aging);
+    }
+    if (s->owner) {
+        free(s->scratch);
+    }
+    pq_free(s->ready);
+    free(s);
+}
+
+/* Writes the slice bookkeeping and the queues in heap order
+ * Scratch is left out: PP only uses it within one tick, and MLFQ saves
+ * its levels itself
+ */
+static int save_state(void* state, FILE* out, int ids) {
+    PolicyState* s = (PolicyState*)state;
+    int ok = fwrite(&s->slice_start, sizeof(int), 1, out) == 1 &&
+             fwrite(&s->slice_used, sizeof(int), 1, out) == 1 &&
+             fwrite(&s->next_boost, sizeof(long long), 1, out) == 1 &&
+             pq_save(s->ready, out) == 0 &&
+             (s->aging == NULL || pq_save(s->aging, out) == 0);
+    return ok ? 0 : -1;
+}
+
+// Reads back what save_state wrote
+static int load_state(void* state, FILE* in, int ids) {
+    PolicyState* s = (PolicyState*)state;
+    int ok = fread(&s->slice_start, sizeof(int), 1, in) == 1 &&
+             fread(&s->slice_used, sizeof(int), 1, in) == 1 &&
+             fread(&s->next_boost, sizeof(long long), 1, in) == 1 &&
+             pq_load(s->ready, in) == 0 &&
+             (s->aging == NULL || pq_load(s->aging, in) == 0);
+    return ok ? 0 : -1;
+}
+
+// Removes the top of the ready queue, or returns -1 if it is empty
+static int pop_ready(void* state, int now) {
+    PolicyState* s = (PolicyState*)state;
+    return pq_isempty(s->ready) ? -1 : pq_pop(s->ready);
+}
+
+
+/* First-Come First-Served
+ * One key for everyone, so the ready queue is plain FIFO
+ */
+static void fcfs_arrival(void* state, int id, int now) {
+    pq_push(((PolicyState*)state)->ready, id, 0);
+}
+
+/* Each policy's table entry comes with the engine loop compiled for it
+ * (sim_kernel.h): its hooks are called directly, and the checks for
+ * hooks it lacks are not compiled in, so FCFS never looks at aging,
+ * preemption or deadlines
+ */
+#define KERNEL_NAME fcfs
+#define KERNEL_ON_ARRIVAL fcfs_arrival
+#define KERNEL_PICK_NEXT pop_ready
+#define KERNEL_STEAL pop_ready
+#include "sim_kernel.h"
+
+static const SimPolicy fcfs_policy = {
+    "FCFS", 0, 0, 0, create_state, destroy_state, fcfs_arrival, pop_ready,
+    NULL, NULL, NULL, NULL, NULL, pop_ready, save_state, load_state,
+    &fcfs_kernel
+};
+
+
+/* Preemptive Priority with aging
+ * Higher priority runs first and preempts; a process that has waited
+ * aging_interval since it was queued or last aged goes up one level.
+ * Aging is lazy: only processes whose deadline has come due are touched.
+ */
+static void* pp_create(ProcTable* procs, const SimConfig* config, int cpu, void* share) {
+    PolicyState* s = (PolicyState*)create_state(procs, config, cpu, share);
+    s->aging = new_queue(procs, share ? ((PolicyState*)share)->aging : NULL);
+    create_scratch(s, share);
+    return s;
+}
+
+// Queues a process and starts its aging clock
+static void pp_arrival(void* state, int id, int now) {
+    PolicyState* s = (PolicyState*)state;
+    s->procs->last_aged_at[id] = now;
+    pq_push(s->ready, id, s->procs->priority[id]);
+    // Earliest aging clock on top; every process ages after the same interval
+    pq_push(s->aging, id, -now);
+}
+
+static int pp_pick(void* state, int now) {
+    PolicyState* s = (PolicyState*)state;
+    int id = pop_ready(state, now);
+    if (id != -1) {
+        pq_remove(s->aging, id);
+    }
+    return id;
+}
+
+/* Ages the ready processes whose aging deadline has come due
+ * The raise is derived from the time elapsed since last_aged_at, so no
+ * per-tick bookkeeping is needed
+ */
+static void pp_tick(void* state, int running, int now) {
+    PolicyState* s = (PolicyState*)state;
+    ProcTable* procs = s->procs;
+    const SimConfig* config = s->config;
+    int* aged = s->scratch;
+    int num_aged = 0;
+
+    while (!pq_isempty(s->aging)) {
+        int id = pq_peek(s->aging);
+        if (procs->last_aged_at[id] + config->aging_interval > now) {
+            break;
+        }
+        pq_pop(s->aging);
+
+        // Insert in report order: queue order, or trace order if asked
+        int j = num_aged++;
+        while (j > 0 && (config->age_by_index ? aged[j - 1] > id :
+                         pq_seq(s->ready, aged[j - 1]) > pq_seq(s->ready, id))) {
+            aged[j] = aged[j - 1];
+            j--;
+        }
+        aged[j] = id;
+    }
+
+    for (int i = 0; i < num_aged; i++) {
+        int id = aged[i];
+        int steps = (now - procs->last_aged_at[id]) / config->aging_interval;
+        procs->priority[id] += steps;
+        procs->last_aged_at[id] += steps * config->aging_interval;
+        pq_change_key(s->ready, id, procs->priority[id]);
+        pq_push(s->aging, id, -procs->last_aged_at[id]);
+        for (int k = 0; k < steps; k++) {
+            sim_emit(config, EV_AGE, now, now, procs->pid[id], s->cpu);
+        }
+    }
+}
+
+static int pp_preempt(void* state, int running, int now) {
+    PolicyState* s = (PolicyState*)state;
+    int top = pq_peek(s->ready);
+    return top != -1 && s->procs->priority[top] > s->procs->priority[running];
+}
+
+static int pp_deadline(void* state, int running, int now) {
+    PolicyState* s = (PolicyState*)state;
+    if (pq_isempty(s->aging)) {
+        return INT_MAX;
+    }
+    return s->procs->last_aged_at[pq_peek(s->aging)] + s->config->aging_interval;
+}
+
+#define KERNEL_NAME pp
+#define KERNEL_ON_ARRIVAL pp_arrival
+#define KERNEL_PICK_NEXT pp_pick
+#define KERNEL_ON_TICK pp_tick
+#define KERNEL_SHOULD_PREEMPT pp_preempt
+#define KERNEL_NEXT_DEADLINE pp_deadline
+#define KERNEL_STEAL pp_pick
+#include "sim_kernel.h"
+
+static const SimPolicy pp_policy = {
+    "PP", 1, 0, 1, pp_create, destroy_state, pp_arrival, pp_pick,
+    pp_tick, pp_preempt, NULL, NULL, pp_deadline, pp_pick, save_state, load_state,
+    &pp_kernel
+};
+
+
+/* Round Robin
+ * FIFO queue; the running process goes to the back after each quantum
+ * if anyone is waiting, otherwise it starts a fresh quantum
+ */
+static int rr_pick(void* state, int now) {
+    PolicyState* s = (PolicyState*)state;
+    s->slice_start = now;
+    return pop_ready(state, now);
+}
+
+static void rr_tick(void* state, int running, int now) {
+    PolicyState* s = (PolicyState*)state;
+    if (running != -1 && now - s->slice_start >= s->config->quantum &&
+        pq_isempty(s->ready)) {
+        s->slice_start = now;
+    }
+}
+
+static int rr_preempt(void* state, int running, int now) {
+    PolicyState* s = (PolicyState*)state;
+    return now - s->slice_start >= s->config->quantum && !pq_isempty(s->ready);
+}
+
+static int rr_deadline(void* state, int running, int now) {
+    PolicyState* s = (PolicyState*)state;
+    return running == -1 ? INT_MAX : s->slice_start + s->config->quantum;
+}
+
+#define KERNEL_NAME rr
+#define KERNEL_ON_ARRIVAL fcfs_arrival
+#define KERNEL_PICK_NEXT rr_pick
+#define KERNEL_ON_TICK rr_tick
+#define KERNEL_SHOULD_PREEMPT rr_preempt
+#define KERNEL_NEXT_DEADLINE rr_deadline
+#define KERNEL_STEAL pop_ready
+#include "sim_kernel.h"
+
+static const SimPolicy rr_policy = {
+    "RR", 0, 1, 0, create_state, destroy_state, fcfs_arrival, rr_pick,
+    rr_tick, rr_preempt, NULL, NULL, rr_deadline, pop_ready, save_state, load_state,
+    &rr_kernel
+};
+
+
+/* Shortest Job First
+ * Non-preemptive; the shortest burst runs next, ties in arrival order.
+ * A process waking from I/O is keyed on its next CPU burst
+ */
+static void sjf_arrival(void* state, int id, int now) {
+    PolicyState* s = (PolicyState*)state;
+    pq_push(s->ready, id, -s->procs->remaining_time[id]);
+}
+
+#define KERNEL_NAME sjf
+#define KERNEL_ON_ARRIVAL sjf_arrival
+#define KERNEL_PICK_NEXT pop_ready
+#define KERNEL_STEAL pop_ready
+#include "sim_kernel.h"
+
+static const SimPolicy sjf_policy = {
+    "SJF", 0, 0, 0, create_state, destroy_state, sjf_arrival, pop_ready,
+    NULL, NULL, NULL, NULL, NULL, pop_ready, save_state, load_state,
+    &sjf_kernel
+};
+
+
+/* Shortest Remaining Time First
+ * Preemptive SJF: a process with strictly less time left takes the CPU
+ */
+static void srtf_arrival(void* state, int id, int now) {
+    PolicyState* s = (PolicyState*)state;
+    pq_push(s->ready, id, -s->procs->remaining_time[id]);
+}
+
+static int srtf_preempt(void* state, int running, int now) {
+    PolicyState* s = (PolicyState*)state;
+    int top = pq_peek(s->ready);
+    return top != -1 && s->procs->remaining_time[top] < s->procs->remaining_time[running];
+}
+
+#define KERNEL_NAME srtf
+#define KERNEL_ON_ARRIVAL srtf_arrival
+#define KERNEL_PICK_NEXT pop_ready
+#define KERNEL_SHOULD_PREEMPT srtf_preempt
+#define KERNEL_STEAL pop_ready
+#include "sim_kernel.h"
+
+static const SimPolicy srtf_policy = {
+    "SRTF", 0, 0, 0, create_state, destroy_state, srtf_arrival, pop_ready,
+    NULL, srtf_preempt, NULL, NULL, NULL, pop_ready, save_state, load_state,
+    &srtf_kernel
+};
+
+
+/* Multi-Level Feedback Queue
+ * MLFQ_LEVELS queues, highest first, round robin within each; level n
+ * gets a slice of quantum << n. Using a whole slice moves a process down
+ * a level; every MLFQ_BOOST top-level slices everything goes back to the
+ * top so long jobs cannot starve.
+ */
+static void* mlfq_create(ProcTable* procs, const SimConfig* config, int cpu, void* share) {
+    PolicyState* s = (PolicyState*)create_state(procs, config, cpu, share);
+    create_scratch(s, share);   // levels; all start at level 0
+    s->next_boost = (long long)config->quantum * MLFQ_BOOST;
+    return s;
+}
+
+// Queues a process at its level; higher levels have higher keys
+static void mlfq_arrival(void* state, int id, int now) {
+    PolicyState* s = (PolicyState*)state;
+    pq_push(s->ready, id, MLFQ_LEVELS - 1 - s->scratch[id]);
+}
+
+// Length of the slice for a process at its current level
+static int mlfq_slice(PolicyState* s, int id) {
+    return s->config->quantum << s->scratch[id];
+}
+
+/* Moves the running process down when its slice is used up, starting a
+ * new slice at the lower level, and boosts everyone when it is time
+ */
+static void mlfq_tick(void* state, int running, int now) {
+    PolicyState* s = (PolicyState*)state;
+
+    s->slice_used = running != -1 && now - s->slice_start >= mlfq_slice(s, running);
+    if (s->slice_used) {
+        if (s->scratch[running] < MLFQ_LEVELS - 1) {
+            s->scratch[running]++;
+        }
+        s->slice_start = now;
+    }
+
+    if (now >= s->next_boost) {
+        long long period = (long long)s->config->quantum * MLFQ_BOOST;
+        s->next_boost += ((now - s->next_boost) / period + 1) * period;
+        // Raising a key only moves it toward the root, through slots
+        // already visited, so one pass over the heap reaches every process
+        for (int slot = 0; slot < pq_length(s->ready); slot++) {
+            int id = pq_at(s->ready, slot);
+            s->scratch[id] = 0;
+            pq_change_key(s->ready, id, MLFQ_LEVELS - 1);
+        }
+        if (running != -1) {
+            s->scratch[running] = 0;
+            s->slice_start = now;   // a fresh top-level slice
+        }
+    }
+}
+
+// Puts a finished process's id back at the top, in case it is used again
+static void mlfq_finish(void* state, int id, int now) {
+    ((PolicyState*)state)->scratch[id] = 0;
+}
+
+// Preempts for a higher level, or for the same level once the slice is over
+static int mlfq_preempt(void* state, int running, int now) {
+    PolicyState* s = (PolicyState*)state;
+    int top = pq_peek(s->ready);
+    if (top == -1) {
+        return 0;
+    }
+    return s->scratch[top] < s->scratch[running] ||
+           (s->slice_used && s->scratch[top] == s->scratch[running]);
+}
+
+static int mlfq_deadline(void* state, int running, int now) {
+    PolicyState* s = (PolicyState*)state;
+    long long next = LLONG_MAX;
+    if (running != -1) {
+        // A boost restarts the running process's slice, so it counts
+        // even when nobody is waiting. A CPU that just stole its process
+        // was idle, so missed boosts with nothing to boost; the next one
+        // is the first after now
+        long long boost = s->next_boost;
+        if (boost <= now) {
+            long long period = (long long)s->config->quantum * MLFQ_BOOST;
+            boost += ((now - boost) / period + 1) * period;
+        }
+        next = (long long)s->slice_start + mlfq_slice(s, running);
+        if (boost < next) {
+            next = boost;
+        }
+    }
+    return next < INT_MAX ? (int)next : INT_MAX;
+}
+
+// Levels belong to CPU 0's state, which saves them for every CPU
+static int mlfq_save(void* state, FILE* out, int ids) {
+    PolicyState* s = (PolicyState*)state;
+    if (save_state(state, out, ids) != 0) {
+        return -1;
+    }
+    return !s->owner || fwrite(s->scratch, sizeof(int), ids, out) == (size_t)ids ? 0 : -1;
+}
+
+static int mlfq_load(void* state, FILE* in, int ids) {
+    PolicyState* s = (PolicyState*)state;
+    if (load_state(state, in, ids) != 0) {
+        return -1;
+    }
+    return !s->owner || fread(s->scratch, sizeof(int), ids, in) == (size_t)ids ? 0 : -1;
+}
+
+#define KERNEL_NAME mlfq
+#define KERNEL_ON_ARRIVAL mlfq_arrival
+#define KERNEL_PICK_NEXT rr_pick
+#define KERNEL_ON_TICK mlfq_tick
+#define KERNEL_SHOULD_PREEMPT mlfq_preempt
+#define KERNEL_ON_FINISH mlfq_finish
+#define KERNEL_NEXT_DEADLINE mlfq_deadline
+#define KERNEL_STEAL pop_ready
+#include "sim_kernel.h"
+
+static const SimPolicy mlfq_policy = {
+    "MLFQ", 0, 1, 0, mlfq_create, destroy_state, mlfq_arrival, rr_pick,
+    mlfq_tick, mlfq_preempt, NULL, mlfq_finish, mlfq_deadline, pop_ready, mlfq_save, mlfq_load,
+    &mlfq_kernel
+};
+
+
+// Every policy the engine knows about
+static const SimPolicy* const policies[] = {
+    &fcfs_policy, &pp_policy, &rr_policy, &sjf_policy, &srtf_policy, &mlfq_policy
+};
+
+// Finds a policy by its command line name
+const SimPolicy* sim_find_policy(const char* name) {
+    for (size_t i = 0; i < sizeof(policies) / sizeof(policies[0]); i++) {
+        if (strcmp(policies[i]->name, name) == 0) {
+            return policies[i];
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,624 @@
+/*
+ * trace_loader.c - Fast loading of process traces for the schedulers
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "trace_loader.h"
+#include "format_int.h"
+
+#define READ_BLOCK (1 << 20)   // bytes per read() when input cannot be mapped
+
+// Binary columns are copied straight into the table, so int must be int32_t
+typedef char int_is_32_bits[sizeof(int) == sizeof(int32_t) ? 1 : -1];
+
+/* Parser state, kept between blocks so numbers may span a block boundary */
+typedef struct {
+    const char* name;       // file name for error messages
+    ProcTable* table;       // loaded processes
+    int fields;             // numbers per record
+    int values[4];          // record being assembled
+    int field;              // values filled so far
+    long long number;       // number being assembled
+    int negative;
+    int in_number;          // a digit or sign has been seen
+    int digits;
+    int line;               // current line, from 1; each record is one line
+    int done;               // pid 0 sentinel was read
+    int* bursts;            // burst lengths of the current record's cpu_time list
+    int num_bursts;
+    int bursts_capacity;
+} TraceParser;
+
+// Reports bad input with its location and exits
+static void parse_error(TraceParser* p, const char* message) {
+    fprintf(stderr, "%s:%d: %s\n", p->name, p->line, message);
+    exit(1);
+}
+
+// Sizes the process table to hold capacity records, creating it if need be
+static int try_reserve(TraceParser* p, int capacity) {
+    if (p->table->arena == NULL) {
+        return proc_table_init(p->table, capacity);
+    }
+    return proc_table_reserve(p->table, capacity);
+}
+
+// Sizes the process table or exits
+static void reserve(TraceParser* p, int capacity) {
+    if (try_reserve(p, capacity) != 0) {
+        fprintf(stderr, "Failed to allocate memory for %d processes\n", capacity);
+        exit(1);
+    }
+}
+
+// Appends the assembled record to the table, doubling it as needed
+static void add_record(TraceParser* p) {
+    ProcTable* table = p->table;
+    if (table->count == table->capacity) {
+        reserve(p, table->capacity > 512 ? table->capacity * 2 : 1024);
+    }
+    int priority = p->fields == 4 ? p->values[3] : 0;  // Default priority for FCFS
+    int id = proc_table_add(table, p->values[0], p->values[1], p->values[2], priority);
+    if (p->num_bursts > 0) {
+        if (proc_table_set_bursts(table, id, p->bursts, p->num_bursts) != 0) {
+            fprintf(stderr, "Failed to allocate memory for I/O bursts\n");
+            exit(1);
+        }
+        p->num_bursts = 0;
+    }
+    p->field = 0;
+}
+
+// Adds a length to the cpu_time field's burst list
+static void add_burst(TraceParser* p, int length) {
+    if (length <= 0) {
+        parse_error(p, "burst lengths must be positive");
+    }
+    if (p->num_bursts == p->bursts_capacity) {
+        p->bursts_capacity = p->bursts_capacity > 0 ? p->bursts_capacity * 2 : 16;
+        p->bursts = (int*)realloc(p->bursts, (size_t)p->bursts_capacity * sizeof(int));
+        if (p->bursts == NULL) {
+            fprintf(stderr, "Failed to allocate memory for I/O bursts\n");
+            exit(1);
+        }
+    }
+    p->bursts[p->num_bursts++] = length;
+}
+
+// Checks a finished burst list and returns its total CPU time
+static int end_bursts(TraceParser* p) {
+    long long cpu_time = 0;
+    long long io_time = 0;
+    if (p->num_bursts % 2 == 0) {
+        parse_error(p, "bursts must alternate CPU and I/O, starting and ending with CPU");
+    }
+    for (int b = 0; b < p->num_bursts; b++) {
+        if (b % 2 == 0) {
+            cpu_time += p->bursts[b];
+        } else {
+            io_time += p->bursts[b];
+        }
+    }
+    if (cpu_time > INT_MAX) {
+        parse_error(p, "number out of range");
+    }
+    if (io_time > SIM_MAX_TIME) {
+        char message[64];
+        snprintf(message, sizeof(message), "total I/O time is more than %d", SIM_MAX_TIME);
+        parse_error(p, message);
+    }
+    return (int)cpu_time;
+}
+
+// Stores a number into the current record; numbers past the last field are only counted
+static void store_number(TraceParser* p, long long number, int negative) {
+    int value = (int)(negative ? -number : number);
+    if (p->field == 2 && p->num_bursts > 0) {
+        add_burst(p, value);    // the last of a cpu_time burst list
+        value = end_bursts(p);
+    }
+    if (p->field < p->fields) {
+        p->values[p->field] = value;
+    }
+    p->field++;
+    if (p->field == 1 && value == 0) {
+        p->done = 1;    // pid 0 marks the end of the trace
+    }
+}
+
+// Checks the record on the line just ended and adds it; blank lines are skipped
+static void end_record(TraceParser* p) {
+    if (p->num_bursts > 0 && p->field == 2) {
+        parse_error(p, "a burst list may not end with a comma");
+    }
+    if (p->field == 0) {
+        return;
+    }
+    if (p->field != p->fields) {
+        char message[64];
+        snprintf(message, sizeof(message), "expected %d fields, got %d", p->fields, p->field);
+        parse_error(p, message);
+    }
+    if (p->values[0] < 0) {
+        parse_error(p, "pid must be positive");
+    }
+    if (p->values[1] < 0) {
+        parse_error(p, "arrival_time must not be negative");
+    }
+    if (p->values[2] <= 0) {
+        parse_error(p, "cpu_time must be positive");
+    }
+    add_record(p);
+}
+
+/* Parses one block of input; stops early once the sentinel is read
+ * The number being assembled lives in locals for speed and is saved
+ * back to the parser so it can continue into the next block
+ */
+static void parse_block(TraceParser* p, const char* buf, size_t len) {
+    const char* s = buf;
+    const char* end = buf + len;
+    long long number = p->number;
+    int negative = p->negative;
+    int in_number = p->in_number;
+    int digits = p->digits;
+
+    while (s < end && !p->done) {
+        char c = *s++;
+        if (c >= '0' && c <= '9') {
+            number = number * 10 + (c - '0');
+            if (number > (long long)INT_MAX + negative) {
+                parse_error(p, "number out of range");
+            }
+            in_number = 1;
+            digits++;
+            continue;
+        }
+        if (in_number) {
+            if (digits == 0) {
+                parse_error(p, "sign without a number");
+            }
+            if (c == ',') {
+                // Another burst follows; only cpu_time may be a list
+                if (p->field != 2) {
+                    parse_error(p, "only cpu_time may be a list of bursts");
+                }
+                add_burst(p, (int)(negative ? -number : number));
+                number = 0;
+                negative = 0;
+                in_number = 0;
+                digits = 0;
+                continue;
+            }
+            store_number(p, number, negative);
+            number = 0;
+            negative = 0;
+            in_number = 0;
+            digits = 0;
+            if (p->done) {
+                break;
+            }
+        }
+        if (c == '\n') {
+            end_record(p);
+            p->line++;
+        } else if (c == '-' || c == '+') {
+            negative = c == '-';
+            in_number = 1;
+        } else if (c != ' ' && c != '\t' && c != '\r' && c != '\v' && c != '\f') {
+            char message[64];
+            snprintf(message, sizeof(message), "expected a number, found '%c'", c);
+            parse_error(p, message);
+        }
+    }
+
+    p->number = number;
+    p->negative = negative;
+    p->in_number = in_number;
+    p->digits = digits;
+}
+
+// Bytes one padded int32 column of count values takes up
+static size_t column_bytes(size_t count) {
+    return (count * sizeof(int32_t) + 7) & ~(size_t)7;
+}
+
+// Checks for the binary trace magic
+static int is_binary(const char* data, size_t len) {
+    return len >= sizeof(TraceHeader) && memcmp(data, TRACE_MAGIC, 8) == 0;
+}
+
+// Reports a bad binary trace and exits
+static void binary_error(TraceParser* p, const char* message) {
+    fprintf(stderr, "%s: %s\n", p->name, message);
+    exit(1);
+}
+
+// Reports a bad process in a binary trace, numbered from 1, and exits
+static void binary_record_error(TraceParser* p, size_t index, const char* message) {
+    fprintf(stderr, "%s: process %zu: %s\n", p->name, index + 1, message);
+    exit(1);
+}
+
+// Builds the process table straight from the columns of a binary trace
+static void load_binary(TraceParser* p, const char* data, size_t len) {
+    TraceHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.version < 1 || header.version > TRACE_VERSION) {
+        binary_error(p, "unsupported binary trace version");
+    }
+    if (header.count > INT_MAX) {
+        binary_error(p, "binary trace has too many processes");
+    }
+    int has_priority = (header.flags & TRACE_HAS_PRIORITY) != 0;
+    if (p->fields == 4 && !has_priority) {
+        binary_error(p, "binary trace has no priority column");
+    }
+
+    int has_bursts = (header.flags & TRACE_HAS_BURSTS) != 0;
+    if (has_bursts && header.version < 2) {
+        binary_error(p, "unsupported binary trace version");
+    }
+
+    size_t count = (size_t)header.count;
+    size_t column = column_bytes(count);
+    size_t columns = (has_priority ? 4 : 3) + has_bursts;
+    if (len < sizeof(header) + column * columns) {
+        binary_error(p, "binary trace is truncated");
+    }
+    const int32_t* pid = (const int32_t*)(data + sizeof(header));
+    const int32_t* arrival = (const int32_t*)((const char*)pid + column);
+    const int32_t* cpu_time = (const int32_t*)((const char*)arrival + column);
+    const int32_t* priority = (const int32_t*)((const char*)cpu_time + column);
+    const int32_t* num_bursts = (const int32_t*)((const char*)pid + column * (columns - 1));
+
+    // The same checks the text parser makes on each record
+    for (size_t i = 0; i < count; i++) {
+        if (pid[i] <= 0) {
+            binary_record_error(p, i, "pid must be positive");
+        }
+        if (arrival[i] < 0) {
+            binary_record_error(p, i, "arrival_time must not be negative");
+        }
+        if (cpu_time[i] <= 0) {
+            binary_record_error(p, i, "cpu_time must be positive");
+        }
+    }
+
+    // The table is sized from the header once and filled a column at a time
+    reserve(p, (int)count);
+    ProcTable* table = p->table;
+    size_t bytes = count * sizeof(int);
+    memcpy(table->pid, pid, bytes);
+    memcpy(table->arrival_time, arrival, bytes);
+    memcpy(table->cpu_time, cpu_time, bytes);
+    memcpy(table->remaining_time, cpu_time, bytes);
+    if (has_priority && p->fields == 4) {
+        memcpy(table->priority, priority, bytes);
+    } else {
+        memset(table->priority, 0, bytes);  // Default priority for FCFS
+    }
+    memset(table->start_time, 0xff, bytes);         // all ones: every value is -1
+    memset(table->completion_time, 0xff, bytes);
+    memset(table->last_aged_at, 0xff, bytes);
+    memset(table->flags, 0, count);
+    table->count = (int)count;
+    p->done = 1;
+
+    // The burst lists follow the burst counts, one after another; a single
+    // CPU burst is just cpu_time and has no list
+    if (has_bursts) {
+        const int32_t* lengths = (const int32_t*)((const char*)num_bursts + column);
+        size_t left = (len - sizeof(header) - column * columns) / sizeof(int32_t);
+        for (size_t i = 0; i < count; i++) {
+            size_t n = (size_t)num_bursts[i];
+            if (num_bursts[i] < 1 || n % 2 == 0) {
+                binary_record_error(p, i, "bursts must alternate CPU and I/O, starting and ending with CPU");
+            }
+            if (n == 1) {
+                continue;
+            }
+            if (n > left) {
+                binary_record_error(p, i, "burst list runs past the end of the file");
+            }
+            long long total = 0;
+            long long io_time = 0;
+            for (size_t b = 0; b < n; b++) {
+                if (lengths[b] <= 0) {
+                    binary_record_error(p, i, "burst lengths must be positive");
+                }
+                if (b % 2 == 0) {
+                    total += lengths[b];
+                } else {
+                    io_time += lengths[b];
+                }
+            }
+            if (total != cpu_time[i]) {
+                binary_record_error(p, i, "cpu_time is not the total of its CPU bursts");
+            }
+            if (io_time > SIM_MAX_TIME) {
+                char message[64];
+                snprintf(message, sizeof(message), "total I/O time is more than %d", SIM_MAX_TIME);
+                binary_record_error(p, i, message);
+            }
+            if (proc_table_set_bursts(table, (int)i, lengths, (int)n) != 0) {
+                fprintf(stderr, "Failed to allocate memory for I/O bursts\n");
+                exit(1);
+            }
+            lengths += n;
+            left -= n;
+        }
+    }
+}
+
+// Reads everything left on fd onto the end of a malloc'd buffer
+static char* slurp(TraceParser* p, int fd, char* buf, size_t* len, size_t* size) {
+    ssize_t got;
+    do {
+        if (*len == *size) {
+            *size *= 2;
+            buf = (char*)realloc(buf, *size);
+            if (buf == NULL) {
+                fprintf(stderr, "Failed to allocate read buffer\n");
+                exit(1);
+            }
+        }
+        got = read(fd, buf + *len, *size - *len);
+        if (got < 0) {
+            perror(p->name);
+            exit(1);
+        }
+        *len += (size_t)got;
+    } while (got > 0);
+    return buf;
+}
+
+/* Reads a file descriptor that cannot be mapped, one large block at a time
+ * A binary trace is gathered whole; text is parsed block by block
+ */
+static void parse_stream(TraceParser* p, int fd) {
+    size_t size = READ_BLOCK;
+    char* block = (char*)malloc(size);
+    if (block == NULL) {
+        fprintf(stderr, "Failed to allocate read buffer\n");
+        exit(1);
+    }
+
+    // Fill enough of the first block to look for the binary magic
+    size_t len = 0;
+    ssize_t got = 1;
+    while (len < sizeof(TraceHeader) && (got = read(fd, block + len, size - len)) > 0) {
+        len += (size_t)got;
+    }
+    if (got < 0) {
+        perror(p->name);
+        exit(1);
+    }
+    if (is_binary(block, len)) {
+        block = slurp(p, fd, block, &len, &size);
+        load_binary(p, block, len);
+        free(block);
+        return;
+    }
+
+    parse_block(p, block, len);
+    while (!p->done && (got = read(fd, block, READ_BLOCK)) > 0) {
+        parse_block(p, block, (size_t)got);
+    }
+    if (got < 0) {
+        perror(p->name);
+        exit(1);
+    }
+    free(block);
+}
+
+// Parses a whole descriptor, mapping it when it is a regular file
+static void parse_fd(TraceParser* p, int fd) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            posix_madvise(map, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+            if (is_binary((const char*)map, (size_t)st.st_size)) {
+                load_binary(p, (const char*)map, (size_t)st.st_size);
+                munmap(map, (size_t)st.st_size);
+                return;
+            }
+
+            // Size the table once for the most records the file could hold,
+            // so it never has to be copied; the unused tail of each column
+            // is never touched (if that much cannot be had, the table just
+            // grows as it goes)
+            size_t most = (size_t)st.st_size / (2 * p->fields) + 1;
+            if (most < INT_MAX) {
+                try_reserve(p, (int)most);
+            }
+            parse_block(p, (const char*)map, (size_t)st.st_size);
+            munmap(map, (size_t)st.st_size);
+            return;
+        }
+    }
+    parse_stream(p, fd);
+}
+
+/* Rejects a trace whose run could pass SIM_MAX_TIME
+ * Nothing finishes later than the last arrival plus every CPU and I/O
+ * burst run one after another, so the clock stays in range below that
+ */
+static void check_span(TraceParser* p) {
+    const ProcTable* table = p->table;
+    long long last = 0;
+    long long work = 0;
+    for (int i = 0; i < table->count; i++) {
+        last = table->arrival_time[i] > last ? table->arrival_time[i] : last;
+        work += table->cpu_time[i];
+        if (table->io_time != NULL) {
+            work += table->io_time[i];
+        }
+    }
+    if (last + work > SIM_MAX_TIME) {
+        fprintf(stderr, "%s: the last arrival plus all CPU and I/O time (%lld) is more than %d\n",
+                p->name, last + work, SIM_MAX_TIME);
+        exit(1);
+    }
+}
+
+// Loads a trace from a file or standard input
+void load_trace(const char* path, int fields, ProcTable* table) {
+    TraceParser p = { path ? path : "stdin", table, fields,
+                      { 0, 0, 0, 0 }, 0, 0, 0, 0, 0, 1, 0, NULL, 0, 0 };
+    memset(table, 0, sizeof(*table));
+
+    int fd = 0;
+    if (path) {
+        fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            perror(path);
+            exit(1);
+        }
+    }
+    parse_fd(&p, fd);
+    if (path) {
+        close(fd);
+    }
+
+    // The last line may run right up to the end of the input
+    if (!p.done) {
+        parse_block(&p, "\n", 1);
+    }
+    free(p.bursts);
+
+    if (table->arena == NULL) {
+        reserve(&p, 0);     // An empty trace still gets a table to free
+    }
+    check_span(&p);
+}
+
+// Writes out a text buffer once fewer than room bytes are left in it
+static int flush_text(FILE* out, char* buf, char** end, size_t size, size_t room) {
+    size_t used = (size_t)(*end - buf);
+    if (size - used >= room) {
+        return 0;
+    }
+    if (fwrite(buf, 1, used, out) != used) {
+        return -1;
+    }
+    *end = buf;
+    return 0;
+}
+
+/* Writes a text trace, formatting into a local buffer to avoid printf
+ * The buffer is flushed before any number that might not fit, so burst
+ * lists of any length go through it
+ */
+int write_trace_text(FILE* out, const ProcTable* procs, int fields) {
+    int count = procs->count;
+    char buf[1 << 16];
+    char* end = buf;
+
+    for (int i = 0; i <= count; i++) {
+        // The record after the last process is the pid 0 sentinel
+        int values[4] = { 0, 0, 0, 0 };
+        if (i < count) {
+            values[0] = procs->pid[i];
+            values[1] = procs->arrival_time[i];
+            values[2] = procs->cpu_time[i];
+            values[3] = procs->priority[i];
+        }
+        const int* bursts = NULL;
+        if (i < count && procs->first_burst != NULL && procs->first_burst[i] != -1) {
+            bursts = procs->bursts + procs->first_burst[i];
+        }
+        for (int f = 0; f < fields; f++) {
+            if (f == 2 && bursts != NULL) {
+                // cpu_time as its bursts
+                for (int b = 1; b < bursts[0]; b++) {
+                    if (flush_text(out, buf, &end, sizeof(buf), FORMAT_INT_MAX + 1) != 0) {
+                        return -1;
+                    }
+                    end = format_int(end, bursts[b]);
+                    *end++ = ',';
+                }
+                values[f] = bursts[bursts[0]];
+            }
+            if (flush_text(out, buf, &end, sizeof(buf), FORMAT_INT_MAX + 1) != 0) {
+                return -1;
+            }
+            end = format_int(end, values[f]);
+            *end++ = f + 1 < fields ? ' ' : '\n';
+        }
+    }
+    if (fwrite(buf, 1, end - buf, out) != (size_t)(end - buf)) {
+        return -1;
+    }
+    return fflush(out) == 0 ? 0 : -1;
+}
+
+// Writes a binary trace; the table's columns are written out as they are
+int write_trace_binary(FILE* out, const ProcTable* procs, int fields) {
+    int count = procs->count;
+    int has_bursts = 0;
+    for (int i = 0; procs->first_burst != NULL && i < count && !has_bursts; i++) {
+        has_bursts = procs->first_burst[i] != -1;
+    }
+    TraceHeader header;
+    memcpy(header.magic, TRACE_MAGIC, 8);
+    header.version = has_bursts ? TRACE_VERSION : 1;   // readable by older loaders if it can be
+    header.flags = (fields == 4 ? TRACE_HAS_PRIORITY : 0) | (has_bursts ? TRACE_HAS_BURSTS : 0);
+    header.count = (uint64_t)count;
+    if (fwrite(&header, sizeof(header), 1, out) != 1) {
+        return -1;
+    }
+    static const char zeros[8] = { 0 };
+
+    const int* columns[4] = { procs->pid, procs->arrival_time, procs->cpu_time,
+                              procs->priority };
+    size_t padding = column_bytes(count) - count * sizeof(int32_t);
+    for (int column = 0; column < (fields == 4 ? 4 : 3); column++) {
+        if (fwrite(columns[column], sizeof(int32_t), count, out) != (size_t)count) {
+            return -1;
+        }
+        if (padding > 0 && fwrite(zeros, 1, padding, out) != padding) {
+            return -1;
+        }
+    }
+    if (!has_bursts) {
+        return fflush(out) == 0 ? 0 : -1;
+    }
+
+    // Burst counts, then every list of more than one burst in trace order
+    for (int i = 0; i < count; i++) {
+        int32_t n = procs->first_burst[i] == -1 ? 1 : procs->bursts[procs->first_burst[i]];
+        if (fwrite(&n, sizeof(n), 1, out) != 1) {
+            return -1;
+        }
+    }
+    if (padding > 0 && fwrite(zeros, 1, padding, out) != padding) {
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        if (procs->first_burst[i] != -1) {
+            const int* list = procs->bursts + procs->first_burst[i];
+            if (fwrite(list + 1, sizeof(int32_t), list[0], out) != (size_t)list[0]) {
+                return -1;
+            }
+        }
+    }
+    return fflush(out) == 0 ? 0 : -1;
+}
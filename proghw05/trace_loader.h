@@ -0,0 +1,80 @@
+/*
+ * trace_loader.h - prototype functions for loading process traces
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+
+#ifndef TRACE_LOADER_H_
+#define TRACE_LOADER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include "sim_engine.h"
+
+
+/*
+ * Binary trace format, version 2 (little-endian, as written on x86):
+ * a TraceHeader followed by count int32 values per column, in the
+ * order pid, arrival_time, cpu_time and, if TRACE_HAS_PRIORITY is set,
+ * priority. Each column is padded to a multiple of 8 bytes and is
+ * copied into the process table with one memcpy, without parsing.
+ * With TRACE_HAS_BURSTS set, a column of burst counts (1 for a single
+ * CPU burst) follows, then the lengths of every longer burst list, one
+ * list after another; cpu_time is then the total of a process's CPU
+ * bursts. Traces without bursts are version 1.
+ */
+#define TRACE_MAGIC "SCHEDTRC"		// first 8 bytes of a binary trace
+#define TRACE_VERSION 2
+#define TRACE_HAS_PRIORITY 0x1		// flags bit: priority column present
+#define TRACE_HAS_BURSTS 0x2		// flags bit: burst columns present
+
+typedef struct {
+	char magic[8];			// TRACE_MAGIC, not NUL terminated
+	uint32_t version;		// 1, or TRACE_VERSION with bursts
+	uint32_t flags;			// TRACE_HAS_ bits
+	uint64_t count;			// number of processes
+} TraceHeader;
+
+
+/*
+ * loads a trace, either text "pid arrival_time cpu_time [priority]"
+ * records, one per line, or the binary format above, told apart by the magic bytes.
+ * A text cpu_time may instead be a list of bursts such as "5,10,3":
+ * CPU 5, blocked on I/O for 10, then CPU 3
+ * const char* path: trace file to map into memory, or NULL for standard
+ * 			input (mapped if it is a regular file, else read in blocks)
+ * int fields: numbers per text record, 3 without priority or 4 with
+ * 			it; with 4, a binary trace must have a priority column
+ * ProcTable* table: receives the processes in trace order, ready to
+ * 			simulate; release it with proc_table_free
+ * returns: nothing; a text record with pid 0 ends the trace. Bad input
+ * 			prints the file name (and line number for text) and exits, as
+ * 			does a trace that could run past SIM_MAX_TIME
+ */
+void load_trace (const char* path, int fields, ProcTable* table);
+
+/*
+ * writes processes as a text trace ending with a pid 0 record; a process
+ * with bursts has them written as its cpu_time list
+ * FILE* out: stream to write to
+ * int fields: 3 to leave out priorities, 4 to include them
+ * returns: 0 on success, -1 if a write failed
+ */
+int write_trace_text (FILE* out, const ProcTable* procs, int fields);
+
+/*
+ * writes processes as a binary trace
+ * FILE* out: stream to write to
+ * int fields: 3 to leave out the priority column, 4 to include it
+ * returns: 0 on success, -1 if a write failed
+ */
+int write_trace_binary (FILE* out, const ProcTable* procs, int fields);
+
+
+#endif /* TRACE_LOADER_H_ */
@@ -0,0 +1,76 @@
+/*
+ * traceconv.c - Converts scheduler traces between the text and binary formats
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace_loader.h"
+
+// Prints how to run the converter
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [-b | -t] [-3] <input> <output>\n", prog);
+    fprintf(stderr, "  -b  write a binary trace (default)\n");
+    fprintf(stderr, "  -t  write a text trace\n");
+    fprintf(stderr, "  -3  traces have no priority column\n");
+    fprintf(stderr, "  use - for stdin or stdout; either format is accepted as input\n");
+}
+
+int main(int argc, char *argv[]) {
+    int binary = 1;
+    int fields = 4;
+    int arg = 1;
+
+    // Parse the options
+    for (; arg < argc && argv[arg][0] == '-' && argv[arg][1] != '\0'; arg++) {
+        if (strcmp(argv[arg], "-b") == 0) {
+            binary = 1;
+        } else if (strcmp(argv[arg], "-t") == 0) {
+            binary = 0;
+        } else if (strcmp(argv[arg], "-3") == 0) {
+            fields = 3;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (argc - arg != 2) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char* input = argv[arg];
+    const char* output = argv[arg + 1];
+
+    // Load the input trace in whichever format it is
+    ProcTable procs;
+    load_trace(strcmp(input, "-") == 0 ? NULL : input, fields, &procs);
+
+    // Write it back out in the requested format
+    FILE* out = stdout;
+    if (strcmp(output, "-") != 0) {
+        out = fopen(output, binary ? "wb" : "w");
+        if (out == NULL) {
+            perror(output);
+            return 1;
+        }
+    }
+    int result = binary ? write_trace_binary(out, &procs, fields)
+                        : write_trace_text(out, &procs, fields);
+    if (result != 0) {
+        perror(output);
+        return 1;
+    }
+    if (out != stdout && fclose(out) != 0) {
+        perror(output);
+        return 1;
+    }
+
+    proc_table_free(&procs);
+    return 0;
+}
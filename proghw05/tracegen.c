@@ -0,0 +1,497 @@
+/*
+ * tracegen.c - Generates synthetic scheduler traces from a seed
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+#include "trace_loader.h"
+#include "format_int.h"
+
+#define MAX_BURST 1000000000    // bursts are clamped to 1..MAX_BURST
+#define MAX_PRIORITY 1000000    // and priorities to 0..MAX_PRIORITY
+#define BLOCK 4096              // values generated between writes
+#define MAX_IO 1000             // most I/O bursts a job can have
+
+/* Each column has its own random stream, so a column comes out the same
+ * whether it is generated alongside the others (text) or on its own
+ * pass (binary, which is stored column by column)
+ */
+enum { STREAM_ARRIVAL = 1, STREAM_BURST, STREAM_PRIORITY, STREAM_IO };
+
+// xoshiro256** state
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+typedef enum {
+    DIST_FIXED,         // fixed:N, every value N
+    DIST_POISSON,       // poisson:RATE, exponential gaps averaging 1/RATE
+    DIST_BURSTY,        // bursty:LOW,HIGH,LENGTH, Poisson whose rate switches between
+                        //      LOW and HIGH after periods averaging LENGTH
+    DIST_EXP,           // exp:MEAN
+    DIST_PARETO,        // pareto:ALPHA,MIN, heavy tailed
+    DIST_BIMODAL,       // bimodal:SHORT,LONG,P, exp(LONG) with chance P, else exp(SHORT)
+    DIST_UNIFORM,       // uniform:LO,HI, integers LO to HI
+    DIST_GEOMETRIC      // geometric:P, 1 plus the failures before a success of chance P
+} DistKind;
+
+// A distribution parsed from "name:a,b,c"
+typedef struct {
+    DistKind kind;
+    double a;
+    double b;
+    double c;
+} Dist;
+
+// Names each column accepts, with their parameter counts
+typedef struct {
+    const char* name;
+    DistKind kind;
+    int params;
+} DistName;
+
+static const DistName arrival_names[] = {
+    { "poisson", DIST_POISSON, 1 }, { "bursty", DIST_BURSTY, 3 }, { "fixed", DIST_FIXED, 1 },
+    { NULL, DIST_FIXED, 0 }
+};
+static const DistName burst_names[] = {
+    { "exp", DIST_EXP, 1 }, { "pareto", DIST_PARETO, 2 }, { "bimodal", DIST_BIMODAL, 3 },
+    { "fixed", DIST_FIXED, 1 }, { NULL, DIST_FIXED, 0 }
+};
+static const DistName priority_names[] = {
+    { "uniform", DIST_UNIFORM, 2 }, { "geometric", DIST_GEOMETRIC, 1 },
+    { "fixed", DIST_FIXED, 1 }, { NULL, DIST_FIXED, 0 }
+};
+
+// One column's generator: its distribution, random stream and position
+typedef struct {
+    Dist dist;
+    Rng rng;
+    double clock;       // arrivals: time of the last arrival
+    int high;           // bursty: in a high rate period
+    double period_end;  // bursty: when the current period ends
+} Column;
+
+// Prints how to run the generator
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [-n jobs] [-s seed] [-b] [-3] [--arrivals SPEC] [--bursts SPEC]\n"
+                    "       [--priority SPEC] [--io N] [--io-length SPEC] [output]\n", prog);
+    fprintf(stderr, "  --arrivals poisson:RATE | bursty:LOW,HIGH,LENGTH | fixed:GAP   (poisson:0.09)\n");
+    fprintf(stderr, "  --bursts   exp:MEAN | pareto:ALPHA,MIN | bimodal:SHORT,LONG,P | fixed:N  (exp:10)\n");
+    fprintf(stderr, "  --priority uniform:LO,HI | geometric:P | fixed:N   (uniform:1,10)\n");
+    fprintf(stderr, "  --io N gives each job N I/O bursts between N + 1 CPU bursts, each drawn from --bursts\n");
+    fprintf(stderr, "  --io-length exp:MEAN | pareto:ALPHA,MIN | bimodal:SHORT,LONG,P | fixed:N  (exp:20)\n");
+    fprintf(stderr, "  -b writes a binary trace, -3 leaves out priorities; output defaults to stdout\n");
+}
+
+// Next value of a splitmix64 sequence; used to seed the streams
+static uint64_t splitmix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Seeds one column's stream from the user's seed
+static void rng_seed(Rng* rng, uint64_t seed, int stream) {
+    uint64_t x = seed ^ ((uint64_t)stream << 56);
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = splitmix64(&x);
+    }
+}
+
+static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// Next 64 random bits
+static uint64_t rng_next(Rng* rng) {
+    uint64_t* s = rng->s;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+// Uniform in (0, 1], so its log is always defined
+static double rng_unit(Rng* rng) {
+    return ((rng_next(rng) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+// Exponential with the given mean
+static double rng_exp(Rng* rng, double mean) {
+    return -log(rng_unit(rng)) * mean;
+}
+
+/* Parses "name:a,b,c" against a column's names
+ * returns: 0 on success, -1 if the name or parameters are wrong
+ */
+static int parse_dist(const char* spec, const DistName* names, Dist* dist) {
+    const char* colon = strchr(spec, ':');
+    if (colon == NULL) {
+        return -1;
+    }
+    for (const DistName* n = names; n->name != NULL; n++) {
+        if (strlen(n->name) != (size_t)(colon - spec) ||
+            strncmp(spec, n->name, colon - spec) != 0) {
+            continue;
+        }
+        double values[3] = { 0, 0, 0 };
+        const char* p = colon + 1;
+        for (int i = 0; i < n->params; i++) {
+            char* end;
+            values[i] = strtod(p, &end);
+            if (end == p || values[i] < 0 || *end != (i + 1 < n->params ? ',' : '\0')) {
+                return -1;
+            }
+            p = end + 1;
+        }
+        dist->kind = n->kind;
+        dist->a = values[0];
+        dist->b = values[1];
+        dist->c = values[2];
+        return 0;
+    }
+    return -1;
+}
+
+// Checks the parameters make sense for the distribution
+static int check_dist(const Dist* d) {
+    switch (d->kind) {
+    case DIST_POISSON:
+    case DIST_EXP:
+        return d->a > 0;
+    case DIST_BURSTY:
+        return d->b > 0 && d->c > 0;
+    case DIST_PARETO:
+        return d->a > 0 && d->b > 0;
+    case DIST_BIMODAL:
+        return d->a > 0 && d->b > 0 && d->c <= 1;
+    case DIST_UNIFORM:
+        return d->a <= d->b && d->b <= MAX_PRIORITY;
+    case DIST_GEOMETRIC:
+        return d->a > 0 && d->a <= 1;
+    default:
+        return 1;
+    }
+}
+
+// Starts a column's generator at the beginning of the trace
+static void column_start(Column* col, const Dist* dist, uint64_t seed, int stream) {
+    col->dist = *dist;
+    rng_seed(&col->rng, seed, stream);
+    col->clock = 0.0;
+    col->high = 0;
+    col->period_end = dist->kind == DIST_BURSTY ? rng_exp(&col->rng, dist->c) : 0.0;
+}
+
+/* Time of the next arrival
+ * The first job arrives at 0. A bursty gap that runs past the end of its
+ * period is thrown away and redrawn at the new rate from the period's
+ * end, which is exact because exponential gaps have no memory.
+ */
+static double next_arrival(Column* col, long long job) {
+    const Dist* d = &col->dist;
+    if (job == 0) {
+        return 0.0;
+    }
+    switch (d->kind) {
+    case DIST_POISSON:
+        col->clock += rng_exp(&col->rng, 1.0 / d->a);
+        break;
+    case DIST_BURSTY:
+        for (;;) {
+            double rate = col->high ? d->b : d->a;
+            double gap = rate > 0 ? rng_exp(&col->rng, 1.0 / rate) : INFINITY;
+            if (col->clock + gap <= col->period_end) {
+                col->clock += gap;
+                break;
+            }
+            col->clock = col->period_end;
+            col->high = !col->high;
+            col->period_end += rng_exp(&col->rng, d->c);
+        }
+        break;
+    default:
+        col->clock += d->a;
+        break;
+    }
+    return col->clock;
+}
+
+// Next burst length, clamped to 1..most
+static int next_burst(Column* col, int most) {
+    const Dist* d = &col->dist;
+    double burst;
+    switch (d->kind) {
+    case DIST_EXP:
+        burst = rng_exp(&col->rng, d->a);
+        break;
+    case DIST_PARETO:
+        burst = d->b / pow(rng_unit(&col->rng), 1.0 / d->a);
+        break;
+    case DIST_BIMODAL:
+        burst = rng_unit(&col->rng) <= d->c ? rng_exp(&col->rng, d->b)
+                                             : rng_exp(&col->rng, d->a);
+        break;
+    default:
+        burst = d->a;
+        break;
+    }
+    burst = ceil(burst);
+    return burst < 1 ? 1 : burst > most ? most : (int)burst;
+}
+
+// Next priority, clamped to 0..MAX_PRIORITY
+static int next_priority(Column* col) {
+    const Dist* d = &col->dist;
+    double priority;
+    switch (d->kind) {
+    case DIST_UNIFORM: {
+        uint64_t span = (uint64_t)d->b - (uint64_t)d->a + 1;
+        priority = d->a + (double)(rng_next(&col->rng) % span);
+        break;
+    }
+    case DIST_GEOMETRIC:
+        priority = d->a >= 1 ? 1 : 1 + floor(log(rng_unit(&col->rng)) / log(1 - d->a));
+        break;
+    default:
+        priority = d->a;
+        break;
+    }
+    return priority > MAX_PRIORITY ? MAX_PRIORITY : (int)priority;
+}
+
+// Longest CPU burst of a job with io I/O bursts, so its total still fits an int
+static int cpu_burst_limit(int io) {
+    return MAX_BURST / (io + 1);
+}
+
+// A job's CPU time: the sum of its io + 1 CPU bursts
+static int next_cpu_time(Column* col, int io) {
+    int total = 0;
+    for (int b = 0; b <= io; b++) {
+        total += next_burst(col, cpu_burst_limit(io));
+    }
+    return total;
+}
+
+// Converts an arrival to a trace time, stopping if the trace is too long
+static int arrival_time(double t) {
+    if (t >= INT_MAX) {
+        fprintf(stderr, "Arrivals run past the largest trace time; use fewer jobs "
+                        "or a higher rate\n");
+        exit(1);
+    }
+    return (int)t;
+}
+
+// Writes a block of bytes or exits
+static void put(FILE* out, const void* data, size_t len) {
+    if (fwrite(data, 1, len, out) != len) {
+        perror("write");
+        exit(1);
+    }
+}
+
+/* Streams a text trace one record at a time, ending with the pid 0 record
+ * With I/O, cpu_time is the list of bursts, CPU and I/O alternating
+ */
+static void write_text(FILE* out, long long jobs, int fields, int io, Column* cols) {
+    char buf[1 << 16];
+    char* end = buf;
+    for (long long i = 0; i <= jobs; i++) {
+        int values[4] = { 0, 0, 0, 0 };
+        if (i < jobs) {
+            values[0] = (int)(i + 1);
+            values[1] = arrival_time(next_arrival(&cols[0], i));
+            values[2] = io > 0 ? 0 : next_burst(&cols[1], MAX_BURST);
+            values[3] = fields == 4 ? next_priority(&cols[2]) : 0;
+        }
+        for (int f = 0; f < fields; f++) {
+            if (f == 2 && io > 0 && i < jobs) {
+                for (int b = 0; b < io; b++) {
+                    end = format_int(end, next_burst(&cols[1], cpu_burst_limit(io)));
+                    *end++ = ',';
+                    end = format_int(end, next_burst(&cols[3], MAX_BURST));
+                    *end++ = ',';
+                }
+                values[f] = next_burst(&cols[1], cpu_burst_limit(io));
+            }
+            end = format_int(end, values[f]);
+            *end++ = f + 1 < fields ? ' ' : '\n';
+        }
+        if (end - buf > (long)sizeof(buf) - 64 - 24 * (io + 1)) {
+            put(out, buf, end - buf);
+            end = buf;
+        }
+    }
+    put(out, buf, end - buf);
+}
+
+/* Streams a binary trace
+ * The format stores whole columns, so each column is generated on its
+ * own pass, a block at a time; memory stays constant for any job count.
+ * With I/O the CPU bursts are drawn twice, once summed for cpu_time and
+ * again from the start of their stream for the burst lists.
+ */
+static void write_binary(FILE* out, long long jobs, int fields, int io, Column* cols,
+                         uint64_t seed) {
+    TraceHeader header;
+    memcpy(header.magic, TRACE_MAGIC, 8);
+    header.version = io > 0 ? TRACE_VERSION : 1;
+    header.flags = (fields == 4 ? TRACE_HAS_PRIORITY : 0) | (io > 0 ? TRACE_HAS_BURSTS : 0);
+    header.count = (uint64_t)jobs;
+    put(out, &header, sizeof(header));
+
+    int32_t block[BLOCK];
+    for (int column = 0; column < fields + (io > 0); column++) {
+        for (long long i = 0; i < jobs; i += BLOCK) {
+            int n = jobs - i < BLOCK ? (int)(jobs - i) : BLOCK;
+            for (int k = 0; k < n; k++) {
+                switch (column) {
+                case 0:
+                    block[k] = (int32_t)(i + k + 1);
+                    break;
+                case 1:
+                    block[k] = arrival_time(next_arrival(&cols[0], i + k));
+                    break;
+                case 2:
+                    block[k] = next_cpu_time(&cols[1], io);
+                    break;
+                default:
+                    // the burst count column comes after priority, if any
+                    block[k] = column < fields ? next_priority(&cols[2]) : 2 * io + 1;
+                    break;
+                }
+            }
+            put(out, block, n * sizeof(int32_t));
+        }
+        // Columns are padded to a multiple of 8 bytes
+        if (jobs % 2 != 0) {
+            static const char zeros[4] = { 0 };
+            put(out, zeros, sizeof(zeros));
+        }
+    }
+    if (io == 0) {
+        return;
+    }
+
+    // Every job's burst list, a block of whole lists at a time
+    Dist cpu = cols[1].dist;
+    column_start(&cols[1], &cpu, seed, STREAM_BURST);
+    int per_job = 2 * io + 1;
+    for (long long i = 0; i < jobs; ) {
+        int n = 0;
+        for (; i < jobs && n + per_job <= BLOCK; i++) {
+            for (int b = 0; b < per_job; b++) {
+                block[n++] = b % 2 == 0 ? next_burst(&cols[1], cpu_burst_limit(io))
+                                        : next_burst(&cols[3], MAX_BURST);
+            }
+        }
+        put(out, block, n * sizeof(int32_t));
+    }
+}
+
+int main(int argc, char *argv[]) {
+    long long jobs = 1000;
+    uint64_t seed = 1;
+    int binary = 0;
+    int fields = 4;
+    Dist arrivals = { DIST_POISSON, 0.09, 0, 0 };
+    Dist bursts = { DIST_EXP, 10, 0, 0 };
+    Dist priorities = { DIST_UNIFORM, 1, 10, 0 };
+    Dist io_lengths = { DIST_EXP, 20, 0, 0 };
+    int io = 0;
+    int arg = 1;
+
+    // Parse the options
+    for (; arg < argc && argv[arg][0] == '-' && argv[arg][1] != '\0'; arg++) {
+        const char* value = arg + 1 < argc ? argv[arg + 1] : "";
+        int ok = 1;
+        if (strcmp(argv[arg], "-b") == 0) {
+            binary = 1;
+            continue;
+        }
+        if (strcmp(argv[arg], "-3") == 0) {
+            fields = 3;
+            continue;
+        }
+        if (strcmp(argv[arg], "-n") == 0) {
+            char* end;
+            jobs = strtoll(value, &end, 10);
+            ok = *value != '\0' && *end == '\0' && jobs >= 0 && jobs < INT_MAX;
+        } else if (strcmp(argv[arg], "-s") == 0) {
+            char* end;
+            seed = strtoull(value, &end, 10);
+            ok = *value != '\0' && *end == '\0';
+        } else if (strcmp(argv[arg], "--arrivals") == 0) {
+            ok = parse_dist(value, arrival_names, &arrivals) == 0 && check_dist(&arrivals);
+        } else if (strcmp(argv[arg], "--bursts") == 0) {
+            ok = parse_dist(value, burst_names, &bursts) == 0 && check_dist(&bursts);
+        } else if (strcmp(argv[arg], "--priority") == 0) {
+            ok = parse_dist(value, priority_names, &priorities) == 0 && check_dist(&priorities);
+        } else if (strcmp(argv[arg], "--io") == 0) {
+            char* end;
+            long n = strtol(value, &end, 10);
+            ok = *value != '\0' && *end == '\0' && n >= 0 && n <= MAX_IO;
+            io = (int)n;
+        } else if (strcmp(argv[arg], "--io-length") == 0) {
+            ok = parse_dist(value, burst_names, &io_lengths) == 0 && check_dist(&io_lengths);
+        } else {
+            ok = 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "Bad value for %s: %s\n", argv[arg], value);
+            usage(argv[0]);
+            return 1;
+        }
+        arg++;  // skip the option's value
+    }
+    if (argc - arg > 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE* out = stdout;
+    const char* output = arg < argc ? argv[arg] : "-";
+    if (strcmp(output, "-") != 0) {
+        out = fopen(output, binary ? "wb" : "w");
+        if (out == NULL) {
+            perror(output);
+            return 1;
+        }
+    }
+
+    Column cols[4];
+    column_start(&cols[0], &arrivals, seed, STREAM_ARRIVAL);
+    column_start(&cols[1], &bursts, seed, STREAM_BURST);
+    column_start(&cols[2], &priorities, seed, STREAM_PRIORITY);
+    column_start(&cols[3], &io_lengths, seed, STREAM_IO);
+    if (binary) {
+        write_binary(out, jobs, fields, io, cols, seed);
+    } else {
+        write_text(out, jobs, fields, io, cols);
+    }
+
+    if (fflush(out) != 0 || (out != stdout && fclose(out) != 0)) {
+        perror(output);
+        return 1;
+    }
+    return 0;
+}
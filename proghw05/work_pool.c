@@ -0,0 +1,174 @@
+/*
+ * work_pool.c - pthread pool with work stealing for running independent jobs
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "work_pool.h"
+
+#define LINE_SIZE 64    // keeps each thread's share on its own cache line
+
+typedef struct WorkPool WorkPool;
+
+/* One thread and the jobs [next, end) it has left */
+typedef struct {
+    pthread_mutex_t lock;   // guards next and end
+    int next;
+    int end;
+    int index;
+    WorkPool* pool;
+    pthread_t thread;
+} Worker;
+
+// A Worker padded so neighbouring threads do not share a cache line
+typedef union {
+    Worker worker;
+    char pad[(sizeof(Worker) + LINE_SIZE - 1) / LINE_SIZE * LINE_SIZE];
+} WorkerSlot;
+
+struct WorkPool {
+    work_fn fn;
+    void* ctx;
+    int threads;
+    WorkerSlot* slots;
+};
+
+// Takes the next job from a worker's own share, or -1 if it has none
+static int take(Worker* self) {
+    int job = -1;
+    pthread_mutex_lock(&self->lock);
+    if (self->next < self->end) {
+        job = self->next++;
+    }
+    pthread_mutex_unlock(&self->lock);
+    return job;
+}
+
+/* Moves the back half of the biggest other share to self
+ * returns: a job to run now, or -1 once every share is empty
+ */
+static int steal(WorkPool* pool, Worker* self) {
+    for (;;) {
+        Worker* victim = NULL;
+        int most = 0;
+        for (int i = 0; i < pool->threads; i++) {
+            Worker* other = &pool->slots[i].worker;
+            pthread_mutex_lock(&other->lock);
+            int left = other->end - other->next;
+            pthread_mutex_unlock(&other->lock);
+            if (other != self && left > most) {
+                victim = other;
+                most = left;
+            }
+        }
+        if (victim == NULL) {
+            return -1;
+        }
+
+        // The victim keeps the front of its share, which it is working through
+        int first = -1;
+        int end = 0;
+        pthread_mutex_lock(&victim->lock);
+        if (victim->next < victim->end) {
+            first = victim->next + (victim->end - victim->next) / 2;
+            end = victim->end;
+            victim->end = first;
+        }
+        pthread_mutex_unlock(&victim->lock);
+        if (first != -1) {
+            pthread_mutex_lock(&self->lock);
+            self->next = first + 1;
+            self->end = end;
+            pthread_mutex_unlock(&self->lock);
+            return first;
+        }
+        // Someone else emptied it first; look again
+    }
+}
+
+// Runs jobs until there are none left anywhere
+static void* work_loop(void* arg) {
+    Worker* self = (Worker*)arg;
+    WorkPool* pool = self->pool;
+    for (;;) {
+        int job = take(self);
+        if (job == -1) {
+            job = steal(pool, self);
+        }
+        if (job == -1) {
+            break;
+        }
+        pool->fn(pool->ctx, self->index, job);
+    }
+    return NULL;
+}
+
+// Splits the jobs among the threads and runs them
+int work_pool_run(int threads, int jobs, work_fn fn, void* ctx) {
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (threads > jobs && jobs > 0) {
+        threads = jobs;
+    }
+    WorkPool pool = { fn, ctx, threads, NULL };
+    pool.slots = (WorkerSlot*)calloc(threads, sizeof(WorkerSlot));
+    if (pool.slots == NULL) {
+        fprintf(stderr, "Failed to allocate memory for worker threads\n");
+        exit(1);
+    }
+    for (int i = 0; i < threads; i++) {
+        Worker* w = &pool.slots[i].worker;
+        pthread_mutex_init(&w->lock, NULL);
+        w->next = (int)((long long)jobs * i / threads);
+        w->end = (int)((long long)jobs * (i + 1) / threads);
+        w->index = i;
+        w->pool = &pool;
+    }
+
+    // Thread 0 is the caller; a thread that fails to start leaves its
+    // share to be stolen by the others
+    int started = 1;
+    int* running = (int*)calloc(threads, sizeof(int));
+    if (running == NULL) {
+        fprintf(stderr, "Failed to allocate memory for worker threads\n");
+        exit(1);
+    }
+    for (int i = 1; i < threads; i++) {
+        Worker* w = &pool.slots[i].worker;
+        if (pthread_create(&w->thread, NULL, work_loop, w) == 0) {
+            running[i] = 1;
+            started++;
+        }
+    }
+    work_loop(&pool.slots[0].worker);
+    for (int i = 1; i < threads; i++) {
+        if (running[i]) {
+            pthread_join(pool.slots[i].worker.thread, NULL);
+        }
+    }
+
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_destroy(&pool.slots[i].worker.lock);
+    }
+    free(running);
+    free(pool.slots);
+    return started;
+}
+
+// Asks the system how many processors are online
+int work_pool_cpus(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus < 1 ? 1 : (int)cpus;
+}
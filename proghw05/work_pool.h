@@ -0,0 +1,47 @@
+/*
+ * work_pool.h - prototype functions for a pthread pool that runs a fixed set of jobs
+ *
+ * Author: Jacob Johnson
+ * Date: 10/17/2026
+ *
+ * Assignment: HW-Prog05
+ * Course: CSCI 356
+ * Version 1.0
+ */
+
+
+#ifndef WORK_POOL_H_
+#define WORK_POOL_H_
+
+
+/*
+ * runs one job; called from a pool thread
+ * void* ctx: the ctx given to work_pool_run
+ * int worker: which thread is calling, 0 to threads-1, so a job can use
+ * 			per-thread scratch memory without locking
+ * int job: the job to run, 0 to jobs-1
+ */
+typedef void (*work_fn)(void* ctx, int worker, int job);
+
+/*
+ * runs jobs 0 to jobs-1, each exactly once, on a pool of threads
+ * Each thread starts with an even share of the jobs, in order; a thread
+ * that runs out takes half of the biggest share left, so uneven jobs
+ * still keep every thread busy.
+ * int threads: threads to use; the calling thread is one of them
+ * int jobs: number of jobs
+ * work_fn fn: runs a job
+ * void* ctx: passed back to fn
+ * returns: the number of threads that ran jobs (fewer than asked if a
+ * 			thread could not be started)
+ */
+int work_pool_run (int threads, int jobs, work_fn fn, void* ctx);
+
+/*
+ * counts the processors available to a pool
+ * returns: the number of online processors, at least 1
+ */
+int work_pool_cpus (void);
+
+
+#endif /* WORK_POOL_H_ */
@@ -1,6 +1,6 @@
 /*
 Summary of File: This file implements a CPU scheduler that simulates different scheduling 
-algorithms (FCFS and PP) given a process trace. The scheduler handles process execution 
+algorithms (FCFS, PP, RR, SJF, SRTF and MLFQ) given a process trace. The scheduler handles process execution 
 scheduling and calculates various performance metrics.
 Name: Devin Guo
 Date: 12/02/2024
@@ -11,177 +11,13 @@ Assignment: ProgHW05: CPU Scheduler Project
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include "my_queue.h"
-
-/* Process Control Block structure 
- * Holds all necessary information about a process including:
- * - Process identification and timing information
- * - Resource usage tracking
- * - State information for scheduling
- */
-typedef struct {
-    int pid;               // Process identifier
-    int arrival_time;      // Time when process arrives in system
-    int cpu_time;         // Total CPU time needed
-    int remaining_time;   // CPU time still needed to complete
-    int priority;         // Process priority (used in PP scheduling)
-    int start_time;       // Time when process first gets CPU (-1 if not started)
-    int wait_time;        // Time spent waiting for CPU
-    int completion_time;  // Time when process completes (-1 if not completed)
-    int preempted;        // Flag indicating if process was preempted
-} PCB;
-
-/* Statistics tracking structure
- * Maintains running totals of various performance metrics
- * Used to calculate final averages and CPU utilization
- */
-typedef struct {
-    int total_time;                  // Total simulation time
-    int cpu_busy_time;               // Time CPU was busy
-    int num_processes;               // Number of completed processes
-    double total_waiting_time;       // Sum of all process waiting times
-    double total_response_time;      // Sum of all process response times
-    double total_turnaround_time;    // Sum of all process turnaround times
-} SchedStats;
+#include "sim_engine.h"
+#include "trace_loader.h"
+#include "event_log.h"
 
 /* Function prototypes */
-PCB* create_process(int pid, int arrival, int cpu_time, int priority);
-void free_process(PCB* proc);
-void print_event(int time, int pid, const char* event);
-PCB* get_highest_priority_process(queue ready_queue);
-void update_aging(queue ready_queue, int current_time);
-void handle_process_completion(PCB* proc, SchedStats* stats, int current_time);
 void print_statistics(SchedStats* stats);
-void run_fcfs(queue job_queue);
-void run_pp(queue job_queue);
-
-/* Prints scheduling events to standard output
- * Formats output according to project specifications:
- * time    pid    event
- */
-void print_event(int time, int pid, const char* event) {
-    if (strcmp(event, "idle") == 0) {
-        printf("%d\twaiting\n", time);
-    } else {
-        printf("%d\t%d\t%s\n", time, pid, event);
-    }
-}
-
-/* Creates and initializes a new Process Control Block
- * Allocates memory and sets initial values for all PCB fields
- * Returns NULL on allocation failure
- */
-PCB* create_process(int pid, int arrival, int cpu_time, int priority) {
-    PCB* proc = (PCB*)malloc(sizeof(PCB));
-    if (!proc) {
-        fprintf(stderr, "Failed to allocate memory for process\n");
-        exit(1);
-    }
-    
-    // Initialize all PCB fields
-    proc->pid = pid;
-    proc->arrival_time = arrival;
-    proc->cpu_time = cpu_time;
-    proc->remaining_time = cpu_time;
-    proc->priority = priority;
-    proc->start_time = -1;          // -1 indicates not started
-    proc->wait_time = 0;
-    proc->completion_time = -1;      // -1 indicates not completed
-    proc->preempted = 0;
-    
-    return proc;
-}
-
-/* Safely frees memory allocated for a PCB */
-void free_process(PCB* proc) {
-    if (proc) {
-        free(proc);
-    }
-}
-
-/* Finds and returns the highest priority process in the ready queue
- * Uses a temporary queue to maintain original queue order
- * Returns NULL if queue is empty
- */
-PCB* get_highest_priority_process(queue ready_queue) {
-    if (isempty(ready_queue)) {
-        return NULL;
-    }
-
-    queue temp_queue = newqueue();
-    PCB* highest_priority_proc = NULL;
-    PCB* current_proc;
-
-    // Search for highest priority process
-    while (!isempty(ready_queue)) {
-        current_proc = (PCB*)dequeue(ready_queue);
-        if (!highest_priority_proc || current_proc->priority > highest_priority_proc->priority) {
-            if (highest_priority_proc) {
-                enqueue(temp_queue, highest_priority_proc);
-            }
-            highest_priority_proc = current_proc;
-        } else {
-            enqueue(temp_queue, current_proc);
-        }
-    }
-
-    // Restore original queue minus highest priority process
-    while (!isempty(temp_queue)) {
-        enqueue(ready_queue, dequeue(temp_queue));
-    }
-    free(temp_queue);
-
-    return highest_priority_proc;
-}
-
-/* Implements the aging mechanism for priority scheduling
- * Increases priority of processes that have waited too long
- * Prevents starvation by gradually increasing process priorities
- */
-void update_aging(queue ready_queue, int current_time) {
-    if (isempty(ready_queue)) {
-        return;
-    }
-
-    queue temp_queue = newqueue();
-    PCB* proc;
-
-    while (!isempty(ready_queue)) {
-        proc = (PCB*)dequeue(ready_queue);
-        // Increase priority after waiting 8 time units
-        if (proc->wait_time >= 8) {
-            proc->priority++;
-            print_event(current_time, proc->pid, "aging");
-            proc->wait_time = 0;  // Reset wait counter after aging
-        }
-        enqueue(temp_queue, proc);
-    }
-
-    // Restore queue with updated priorities
-    while (!isempty(temp_queue)) {
-        enqueue(ready_queue, dequeue(temp_queue));
-    }
-    free(temp_queue);
-}
-
-/* Handles process completion and updates statistics
- * Calculates waiting time, response time, and turnaround time
- * Updates global statistics tracking structure
- */
-void handle_process_completion(PCB* proc, SchedStats* stats, int current_time) {
-    proc->completion_time = current_time;
-    
-    // Calculate performance metrics
-    int wait_time = current_time - proc->arrival_time - proc->cpu_time;
-    int response_time = proc->start_time - proc->arrival_time;
-    int turnaround_time = current_time - proc->arrival_time;
-    
-    // Update global statistics
-    stats->total_waiting_time += wait_time;
-    stats->total_response_time += response_time;
-    stats->total_turnaround_time += turnaround_time;
-    stats->num_processes++;
-}
+void run_policy(ProcTable* table, SimConfig* config, LogLevel level, int bench);
 
 /* Prints final scheduling statistics
  * Calculates and displays average times and CPU utilization
@@ -201,217 +37,177 @@ void print_statistics(SchedStats* stats) {
     printf("Average turnaround time: %.2f\n", 
            stats->total_turnaround_time / stats->num_processes);
     printf("CPU usage: %.2f%%\n", 
-           (stats->cpu_busy_time * 100.0) / stats->total_time);
-}
+           (stats->cpu_busy_time * 100.0) / stats->total_time / stats->num_cpus);
 
-/* First Come First Serve (FCFS) Scheduling Algorithm Implementation
- * - Non-preemptive scheduling
- * - Processes run to completion in arrival order
- * - Maintains ready queue of arrived but not running processes
- */
-void run_fcfs(queue job_queue) {
-    queue ready_queue = newqueue();
-    SchedStats stats = {0, 0, 0, 0.0, 0.0, 0.0};
-    PCB* current_proc = NULL;
-    int current_time = 0;
-
-    // Main scheduling loop
-    while (!isempty(job_queue) || !isempty(ready_queue) || current_proc) {
-        // Move newly arrived processes to ready queue
-        while (!isempty(job_queue)) {
-            PCB* proc = (PCB*)peek(job_queue);
-            if (proc->arrival_time > current_time) {
-                break;
-            }
-            proc = (PCB*)dequeue(job_queue);
-            enqueue(ready_queue, proc);
-            print_event(current_time, proc->pid, "arriving");
-        }
-
-        // Start new process if CPU is idle
-        if (!current_proc && !isempty(ready_queue)) {
-            current_proc = (PCB*)dequeue(ready_queue);
-            if (current_proc->start_time == -1) {
-                current_proc->start_time = current_time;
-            }
-        }
-
-        // Execute current process or idle
-        if (current_proc) {
-            print_event(current_time, current_proc->pid, "running");
-            current_proc->remaining_time--;
-            stats.cpu_busy_time++;
-
-            // Handle process completion
-            if (current_proc->remaining_time == 0) {
-                print_event(current_time + 1, current_proc->pid, "finished");
-                handle_process_completion(current_proc, &stats, current_time + 1);
-                free_process(current_proc);
-                current_proc = NULL;
-            }
-        } else {
-            print_event(current_time, 0, "idle");
+    // With several CPUs, show how evenly the work was spread
+    if (stats->num_cpus > 1) {
+        for (int cpu = 0; cpu < stats->num_cpus; cpu++) {
+            printf("CPU %d usage: %.2f%%\n", cpu,
+                   (stats->cpu_busy[cpu] * 100.0) / stats->total_time);
         }
+        printf("Migrations: %d\n", stats->migrations);
+        printf("Load imbalance: %.2f%%\n", stats->load_imbalance * 100.0);
+    }
+
+    // With dispatch costs or I/O, how much of the busy time went to useful work
+    if (stats->overhead_time > 0 || stats->blocks > 0) {
+        double capacity = (double)stats->total_time * stats->num_cpus;
+        printf("Useful CPU usage: %.2f%%\n",
+               (stats->cpu_busy_time - stats->overhead_time) * 100.0 / capacity);
+        printf("Overhead: %.2f%% (%lld dispatches, %lld switches)\n",
+               stats->overhead_time * 100.0 / capacity, stats->dispatches, stats->switches);
+        printf("I/O blocks: %lld\n", stats->blocks);
+        printf("Throughput: %.4f processes per tick\n",
+               (double)stats->num_processes / stats->total_time);
+    }
+
+    // Tail latencies, from the engine's histograms
+    const char* names[3] = { "Waiting", "Response", "Turnaround" };
+    const LatencyHist* hists[3] = { &stats->waiting, &stats->response, &stats->turnaround };
+    printf("\tp50\tp90\tp99\tmax\tstddev\n");
+    for (int i = 0; i < 3; i++) {
+        printf("%s\t%d\t%d\t%d\t%d\t%.2f\n", names[i],
+               hist_percentile(hists[i], 50), hist_percentile(hists[i], 90),
+               hist_percentile(hists[i], 99), hists[i]->max, hist_stddev(hists[i]));
+    }
+}
 
-        // Update waiting time for processes in ready queue
-        queue temp_queue = newqueue();
-        while (!isempty(ready_queue)) {
-            PCB* proc = (PCB*)dequeue(ready_queue);
-            proc->wait_time++;
-            enqueue(temp_queue, proc);
-        }
-        while (!isempty(temp_queue)) {
-            enqueue(ready_queue, dequeue(temp_queue));
-        }
-        free(temp_queue);
+/* Runs one scheduling algorithm over the trace
+ * - FCFS: non-preemptive, processes run to completion in arrival order
+ * - PP: preemptive on priority, with aging to prevent starvation
+ * - RR, SJF, SRTF, MLFQ: see sim_policy.c
+ */
+void run_policy(ProcTable* table, SimConfig* config, LogLevel level, int bench) {
+    SchedStats stats;
+    EventLog* log = log_open(stdout, level, '\t', "waiting");
+    log->show_cpu = config->cpus > 1;
 
-        current_time++;
-        stats.total_time = current_time;
-    }
+    config->on_event = log_callback(log);
+    config->ctx = log;
+    sim_run(table, config, &stats);
+    log_close(log);
 
     print_statistics(&stats);
-    free(ready_queue);
+    if (bench) {
+        fprintf(stderr, "bench processes=%d ticks=%d events=%lld\n",
+                stats.num_processes, stats.total_time, stats.events);
+    }
 }
 
-/* Preemptive Priority (PP) Scheduling Algorithm Implementation
- * - Preemptive scheduling based on priority
- * - Includes aging mechanism to prevent starvation
- * - Higher priority processes preempt lower priority ones
+/* Main program entry point
+ * Handles command line arguments and input processing
+ * Initiates appropriate scheduling algorithm based on input
  */
-void run_pp(queue job_queue) {
-    queue ready_queue = newqueue();
-    SchedStats stats = {0, 0, 0, 0.0, 0.0, 0.0};
-    PCB* current_proc = NULL;
-    int current_time = 0;
-
-    // Main scheduling loop
-    while (!isempty(job_queue) || !isempty(ready_queue) || current_proc) {
-        // Handle new process arrivals
-        while (!isempty(job_queue)) {
-            PCB* proc = (PCB*)peek(job_queue);
-            if (proc->arrival_time > current_time) {
-                break;
-            }
-            proc = (PCB*)dequeue(job_queue);
-            enqueue(ready_queue, proc);
-            print_event(current_time, proc->pid, "arriving");
+int main(int argc, char* argv[]) {
+    // Options: "-l level" picks how much of the simulation is printed,
+    // "-q quantum" sets the RR and MLFQ time slice, "-a interval" the PP
+    // aging period, "--cpus N" simulates N CPUs with arrivals queued per
+    // "--place" and idle CPUs stealing work unless "--no-steal" is given.
+    // "--dispatch-cost" and "--switch-cost" charge CPU time for every
+    // dispatch and for each switch between processes.
+    // "--bench" adds a line for schedbench to stderr
+    const char* prog = argv[0];
+    int bench = 0;
+    LogLevel level = LOG_FULL;
+    SimConfig config = { NULL, AGING_INTERVAL, QUANTUM, 0, 0, 1, PLACE_ROUND_ROBIN, 1, NULL, NULL };
+    while (argc > 2 && argv[1][0] == '-') {
+        if (strcmp(argv[1], "--no-steal") == 0) {
+            config.steal = 0;
+            argv++;
+            argc--;
+            continue;
         }
-
-        // Update process priorities through aging
-        update_aging(ready_queue, current_time);
-
-        // Check for preemption by higher priority process
-        PCB* highest_priority_proc = get_highest_priority_process(ready_queue);
-        if (highest_priority_proc && (!current_proc || 
-            highest_priority_proc->priority > current_proc->priority)) {
-            if (current_proc) {
-                current_proc->preempted = 1;
-                current_proc->wait_time = 0;  // Reset wait time when preempted
-                enqueue(ready_queue, current_proc);
+        if (strcmp(argv[1], "--bench") == 0) {
+            bench = 1;
+            argv++;
+            argc--;
+            continue;
+        }
+        if (argc < 4) {
+            break;
+        }
+        if (strcmp(argv[1], "-l") == 0) {
+            if (log_parse_level(argv[2], &level) != 0) {
+                printf("Invalid log level: %s\n", argv[2]);
+                return 1;
             }
-            current_proc = highest_priority_proc;
-            current_proc->wait_time = 0;  // Reset wait time when getting CPU
-            if (current_proc->start_time == -1) {
-                current_proc->start_time = current_time;
+        } else if (strcmp(argv[1], "-q") == 0) {
+            config.quantum = atoi(argv[2]);
+            if (config.quantum <= 0) {
+                printf("Invalid quantum: %s\n", argv[2]);
+                return 1;
             }
-        } else if (highest_priority_proc) {
-            enqueue(ready_queue, highest_priority_proc);
-        }
-
-        // Execute current process or idle
-        if (current_proc) {
-            print_event(current_time, current_proc->pid, "running");
-            current_proc->remaining_time--;
-            stats.cpu_busy_time++;
-
-            // Handle process completion
-            if (current_proc->remaining_time == 0) {
-                print_event(current_time + 1, current_proc->pid, "finished");
-                handle_process_completion(current_proc, &stats, current_time + 1);
-                free_process(current_proc);
-                current_proc = NULL;
+        } else if (strcmp(argv[1], "-a") == 0) {
+            config.aging_interval = atoi(argv[2]);
+            if (config.aging_interval <= 0) {
+                printf("Invalid aging interval: %s\n", argv[2]);
+                return 1;
+            }
+        } else if (strcmp(argv[1], "--cpus") == 0) {
+            config.cpus = atoi(argv[2]);
+            if (config.cpus < 1 || config.cpus > SIM_MAX_CPUS) {
+                printf("Invalid number of CPUs: %s\n", argv[2]);
+                return 1;
+            }
+        } else if (strcmp(argv[1], "--place") == 0) {
+            if (strcmp(argv[2], "rr") == 0) {
+                config.placement = PLACE_ROUND_ROBIN;
+            } else if (strcmp(argv[2], "least") == 0) {
+                config.placement = PLACE_LEAST_LOADED;
+            } else {
+                printf("Invalid placement: %s\n", argv[2]);
+                return 1;
+            }
+        } else if (strcmp(argv[1], "--dispatch-cost") == 0 ||
+                   strcmp(argv[1], "--switch-cost") == 0) {
+            int cost = atoi(argv[2]);
+            if (cost < 0 || (cost == 0 && strcmp(argv[2], "0") != 0)) {
+                printf("Invalid cost: %s\n", argv[2]);
+                return 1;
+            }
+            if (argv[1][2] == 'd') {
+                config.dispatch_cost = cost;
+            } else {
+                config.switch_cost = cost;
             }
         } else {
-            print_event(current_time, 0, "idle");
-        }
-
-        // Update waiting time for ready queue processes
-        queue temp_queue = newqueue();
-        while (!isempty(ready_queue)) {
-            PCB* proc = (PCB*)dequeue(ready_queue);
-            proc->wait_time++;
-            enqueue(temp_queue, proc);
-        }
-        while (!isempty(temp_queue)) {
-            enqueue(ready_queue, dequeue(temp_queue));
+            break;
         }
-        free(temp_queue);
-
-        current_time++;
-        stats.total_time = current_time;
+        argv += 2;
+        argc -= 2;
     }
 
-    print_statistics(&stats);
-    free(ready_queue);
-}
-
-/* Main program entry point
- * Handles command line arguments and input processing
- * Initiates appropriate scheduling algorithm based on input
- */
-int main(int argc, char* argv[]) {
     // Verify correct command line usage
-    if (argc != 2) {
-        printf("Usage: %s [FCFS | PP]\n", argv[0]);
+    if (argc != 2 && argc != 3) {
+        printf("Usage: %s [-l full | transitions | stats | intervals] [-q quantum] [-a interval] "
+               "[--cpus N] [--place rr | least] [--no-steal]\n"
+               "       [--dispatch-cost time] [--switch-cost time]\n"
+               "       [--bench] [FCFS | PP | RR | SJF | SRTF | MLFQ] [trace_file]\n", prog);
         return 1;
     }
 
-    // Print input format instructions
+    // Print input format instructions; only PP needs a priority
+    const SimPolicy* policy = sim_find_policy(argv[1]);
+    config.policy = policy;
     printf("Enter tasks in the format: ");
-    if (strcmp(argv[1], "FCFS") == 0) {
-        printf("<id> <arrival_time> <burst_time>\n");
-    } else if (strcmp(argv[1], "PP") == 0) {
-        printf("<id> <arrival_time> <burst_time> <priority>\n");
-    } else {
+    if (policy == NULL) {
         printf("Invalid algorithm: %s\n", argv[1]);
         return 1;
+    } else if (policy->uses_priority) {
+        printf("<id> <arrival_time> <burst_time> <priority>\n");
+    } else {
+        printf("<id> <arrival_time> <burst_time>\n");
     }
     printf("Enter 0 for everything when you're done.\n");
 
     // Read and store process information
-    queue job_queue = newqueue();
-    int pid, arrival_time, cpu_time, priority;
-
-    while (1) {
-        if (scanf("%d", &pid) != 1 || pid == 0) {
-            break;
-        }
-        
-        if (scanf("%d %d", &arrival_time, &cpu_time) != 2) {
-            fprintf(stderr, "Error reading process information\n");
-            return 1;
-        }
+    ProcTable table;
+    load_trace(argc == 3 ? argv[2] : NULL, policy->uses_priority ? 4 : 3, &table);
 
-        priority = 0;  // Default priority for FCFS
-        if (strcmp(argv[1], "PP") == 0) {
-            if (scanf("%d", &priority) != 1) {
-                fprintf(stderr, "Error reading priority\n");
-                return 1;
-            }
-        }
-
-        PCB* proc = create_process(pid, arrival_time, cpu_time, priority);
-        enqueue(job_queue, proc);
-    }
-
-    // Run appropriate scheduling algorithm
-    if (strcmp(argv[1], "FCFS") == 0) {
-        run_fcfs(job_queue);
-    } else if (strcmp(argv[1], "PP") == 0) {
-        run_pp(job_queue);
-    }
+    // Run the chosen scheduling algorithm
+    run_policy(&table, &config, level, bench);
 
-    // Clean up allocated memory
-    free(job_queue);
+    // Clean up allocated memory; the whole table is one allocation
+    proc_table_free(&table);
     return 0;
 }
\ No newline at end of file